@@ -0,0 +1,1110 @@
+/*====================== bytecode.c ========================
+Compiling op[] into a compact program and running it.
+
+compile_ops goes through op[] once, after parsing and loading
+resources. The commands that set up the scene (lights, ambient,
+shading, camera, ...) are resolved into the program header and
+the ones that run every frame are lowered to a flat array of
+words (see bytecode.h) with knobs, constants, coordinate
+systems and meshes already looked up, so run_program never
+touches symbol names or strings.
+==================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "parser.h"
+#include "symtab.h"
+#include "y.tab.h"
+#include "matrix.h"
+#include "ml6.h"
+#include "display.h"
+#include "draw.h"
+#include "stack.h"
+#include "mesh.h"
+#include "bytecode.h"
+
+//lighting constants for shapes that don't name any
+static struct constants default_constants = {
+  {0.2, 0.5, 0.5, 0},
+  {0.2, 0.5, 0.5, 0},
+  {0.2, 0.5, 0.5, 0},
+  0, 0, 0
+};
+
+//number of words in each kind of instruction, operands included
+static int instr_length[] = {
+  1, /* BC_END */
+  1, /* BC_PUSH */
+  1, /* BC_POP */
+  5, /* BC_MOVE */
+  5, /* BC_SCALE */
+  3, /* BC_ROTX */
+  3, /* BC_ROTY */
+  3, /* BC_ROTZ */
+  3, /* BC_SET */
+  2, /* BC_SETKNOBS */
+  7, /* BC_SPHERE */
+  8, /* BC_TORUS */
+  9, /* BC_BOX */
+  4, /* BC_MESH */
+  9, /* BC_LINE */
+  3, /* BC_SAVE_COORDS */
+  2, /* BC_SAVE */
+  1  /* BC_DISPLAY */
+};
+
+/*======== union word * emit() ==========
+Inputs:   struct program *p
+          int n
+Returns: Room for the next n words of p's code
+====================*/
+static union word * emit( struct program *p, int n ) {
+
+  union word *w;
+
+  if ( p->length + n > p->size ) {
+    p->size = p->size ? p->size * 2 : 1024;
+    if ( p->size < p->length + n )
+      p->size = p->length + n;
+    p->code = (union word *)realloc(p->code, p->size * sizeof(union word));
+  }
+  w = p->code + p->length;
+  p->length += n;
+  return w;
+}
+
+static struct constants * constants_of( SYMTAB *s ) {
+
+  if ( s != NULL && s->type == SYM_CONSTANTS )
+    return s->s.c;
+  return &default_constants;
+}
+
+static struct coord_system * coords_of( SYMTAB *s ) {
+
+  if ( s != NULL && s->type == SYM_MATRIX )
+    return s->s.cs;
+  return NULL;
+}
+
+/*======== struct program * compile_ops() ==========
+Inputs:
+Returns: The program for op[]
+
+set and setknobs are only compiled in when there is a single
+frame and the scene isn't served or drawn in a batch; otherwise
+the knobs all come from second_pass's knob table.
+====================*/
+struct program * compile_ops() {
+
+  struct program *p;
+  union word *w;
+  struct light *l;
+  double *eye = NULL, *aim = NULL;
+  double focal = 0;
+  char *shading = "wireframe";
+  int i, n;
+
+  p = (struct program *)calloc(1, sizeof(struct program));
+  p->step = 0.01;
+  p->shrink = 1;
+
+  for (i=0, n=0; i < lastop; i++)
+    if (op[i].opcode == LIGHT)
+      n++;
+  p->lights = (double **)calloc(n + 1, sizeof(double *));
+
+  for (i=0; i < lastop; i++) {
+    switch (op[i].opcode) {
+
+    case SHADING:
+      shading = op[i].op.shading.p->name;
+      break;
+    case AMBIENT:
+      p->ambient.red = (int) op[i].op.ambient.c[0];
+      p->ambient.green = (int) op[i].op.ambient.c[1];
+      p->ambient.blue = (int) op[i].op.ambient.c[2];
+      break;
+    case LIGHT:
+      l = op[i].op.light.p->s.l;
+      p->lights[p->num_lights] = (double *)malloc(6 * sizeof(double));
+      p->lights[p->num_lights][0] = l->c[0];
+      p->lights[p->num_lights][1] = l->c[1];
+      p->lights[p->num_lights][2] = l->c[2];
+      p->lights[p->num_lights][3] = l->l[0];
+      p->lights[p->num_lights][4] = l->l[1];
+      p->lights[p->num_lights][5] = l->l[2];
+      p->num_lights++;
+      break;
+    case CAMERA:
+      eye = op[i].op.camera.eye;
+      aim = op[i].op.camera.aim;
+      break;
+    case FOCAL:
+      focal = op[i].op.focal.value;
+      break;
+
+    case PUSH:
+      emit(p, 1)->i = BC_PUSH;
+      break;
+    case POP:
+      emit(p, 1)->i = BC_POP;
+      break;
+    case DISPLAY:
+      emit(p, 1)->i = BC_DISPLAY;
+      break;
+    case SAVE:
+      w = emit(p, 2);
+      w[0].i = BC_SAVE;
+      w[1].p = op[i].op.save.p->name;
+      break;
+
+    case MOVE:
+    case SCALE:
+      w = emit(p, 5);
+      if ( op[i].opcode == MOVE ) {
+	w[0].i = BC_MOVE;
+	w[1].i = op[i].op.move.knob;
+	w[2].d = op[i].op.move.d[0];
+	w[3].d = op[i].op.move.d[1];
+	w[4].d = op[i].op.move.d[2];
+      }
+      else {
+	w[0].i = BC_SCALE;
+	w[1].i = op[i].op.scale.knob;
+	w[2].d = op[i].op.scale.d[0];
+	w[3].d = op[i].op.scale.d[1];
+	w[4].d = op[i].op.scale.d[2];
+      }
+      break;
+    case ROTATE:
+      w = emit(p, 3);
+      if ( op[i].op.rotate.axis == 0 )
+	w[0].i = BC_ROTX;
+      else if ( op[i].op.rotate.axis == 1 )
+	w[0].i = BC_ROTY;
+      else
+	w[0].i = BC_ROTZ;
+      w[1].i = op[i].op.rotate.knob;
+      w[2].d = op[i].op.rotate.degrees;
+      break;
+
+    case SET:
+      if ( num_frames == 1 && !options.serve && !options.batch_file ) {
+	w = emit(p, 3);
+	w[0].i = BC_SET;
+	w[1].i = op[i].op.set.knob;
+	w[2].d = op[i].op.set.val;
+      }
+      break;
+    case SETKNOBS:
+      if ( num_frames == 1 && !options.serve && !options.batch_file ) {
+	w = emit(p, 2);
+	w[0].i = BC_SETKNOBS;
+	w[1].d = op[i].op.setknobs.value;
+      }
+      break;
+
+    case SPHERE:
+      w = emit(p, 7);
+      w[0].i = BC_SPHERE;
+      w[1].p = constants_of(op[i].op.sphere.constants);
+      w[2].p = coords_of(op[i].op.sphere.cs);
+      w[3].d = op[i].op.sphere.d[0];
+      w[4].d = op[i].op.sphere.d[1];
+      w[5].d = op[i].op.sphere.d[2];
+      w[6].d = op[i].op.sphere.r;
+      break;
+    case TORUS:
+      w = emit(p, 8);
+      w[0].i = BC_TORUS;
+      w[1].p = constants_of(op[i].op.torus.constants);
+      w[2].p = coords_of(op[i].op.torus.cs);
+      w[3].d = op[i].op.torus.d[0];
+      w[4].d = op[i].op.torus.d[1];
+      w[5].d = op[i].op.torus.d[2];
+      w[6].d = op[i].op.torus.r0;
+      w[7].d = op[i].op.torus.r1;
+      break;
+    case BOX:
+      w = emit(p, 9);
+      w[0].i = BC_BOX;
+      w[1].p = constants_of(op[i].op.box.constants);
+      w[2].p = coords_of(op[i].op.box.cs);
+      w[3].d = op[i].op.box.d0[0];
+      w[4].d = op[i].op.box.d0[1];
+      w[5].d = op[i].op.box.d0[2];
+      w[6].d = op[i].op.box.d1[0];
+      w[7].d = op[i].op.box.d1[1];
+      w[8].d = op[i].op.box.d1[2];
+      break;
+    case MESH:
+      //meshes that failed to load are dropped
+      if ( op[i].op.mesh.data == NULL )
+	break;
+      w = emit(p, 4);
+      w[0].i = BC_MESH;
+      w[1].p = constants_of(op[i].op.mesh.constants);
+      w[2].p = coords_of(op[i].op.mesh.cs);
+      w[3].p = op[i].op.mesh.data;
+      break;
+    case LINE:
+      w = emit(p, 9);
+      w[0].i = BC_LINE;
+      w[1].p = coords_of(op[i].op.line.cs0);
+      w[2].p = coords_of(op[i].op.line.cs1);
+      w[3].d = op[i].op.line.p0[0];
+      w[4].d = op[i].op.line.p0[1];
+      w[5].d = op[i].op.line.p0[2];
+      w[6].d = op[i].op.line.p1[0];
+      w[7].d = op[i].op.line.p1[1];
+      w[8].d = op[i].op.line.p1[2];
+      break;
+    case SAVE_COORDS:
+      w = emit(p, 3);
+      w[0].i = BC_SAVE_COORDS;
+      w[1].p = op[i].op.save_coordinate_system.p->s.cs;
+      w[2].i = w - p->code;
+      break;
+    }
+  }
+  emit(p, 1)->i = BC_END;
+
+  if ( !strcmp(shading, "wireframe") )
+    p->shading = SHADE_WIREFRAME;
+  else if ( !strcmp(shading, "flat") )
+    p->shading = SHADE_FLAT;
+  else {
+    printf("Warning: %s shading is not supported, shapes won't be drawn\n", shading);
+    p->shading = SHADE_NONE;
+  }
+
+  //the view-projection matrix doesn't depend on any knob, so it is built once
+  //and becomes the bottom of the stack in every frame
+  if ( eye != NULL ) {
+    if ( focal <= 0 )
+      focal = sqrt((aim[0] - eye[0]) * (aim[0] - eye[0]) +
+		   (aim[1] - eye[1]) * (aim[1] - eye[1]) +
+		   (aim[2] - eye[2]) * (aim[2] - eye[2]));
+    p->camera = make_perspective(eye, aim, focal);
+  }
+  return p;
+}
+
+/*======== struct matrix * shape_coords() ==========
+Inputs:   struct coord_system *cs
+          struct stack *systems
+Returns: The matrix a shape is transformed against
+
+That is cs if the shape names a coordinate system that has
+been saved, and the top of the origin stack otherwise.
+====================*/
+static struct matrix * shape_coords( struct coord_system *cs, struct stack *systems ) {
+
+  if ( cs != NULL && cs->source >= 0 )
+    return &cs->view;
+  return peek(systems);
+}
+
+/*======== void shrink_points() ==========
+Inputs:   struct program *p
+          struct matrix *points
+Returns:
+
+Scales the screen coordinates of points down by p->shrink for
+a preview pass. Depth is scaled too, so normals and the order
+of shapes don't change.
+====================*/
+static void shrink_points( struct program *p, struct matrix *points ) {
+
+  int c;
+
+  if ( p->shrink <= 1 )
+    return;
+  for (c=0; c < points->lastcol; c++) {
+    points->m[0][c]/= p->shrink;
+    points->m[1][c]/= p->shrink;
+    points->m[2][c]/= p->shrink;
+  }
+}
+
+/*======== void points_rect() ==========
+Inputs:   struct matrix *points
+          struct rect *r
+Returns:
+
+Sets r to the screen bounds of points, a pixel past each side
+to cover the rounding in the rasterizers, or to an empty rect
+if they are nowhere near the screen
+====================*/
+static void points_rect( struct matrix *points, struct rect *r ) {
+
+  double x0, y0, x1, y1;
+  int c;
+
+  x0 = x1 = points->m[0][0];
+  y0 = y1 = points->m[1][0];
+  for (c=1; c < points->lastcol; c++) {
+    if ( points->m[0][c] < x0 ) x0 = points->m[0][c];
+    if ( points->m[0][c] > x1 ) x1 = points->m[0][c];
+    if ( points->m[1][c] < y0 ) y0 = points->m[1][c];
+    if ( points->m[1][c] > y1 ) y1 = points->m[1][c];
+  }
+  if ( x1 < -1 || y1 < -1 || x0 > XRES || y0 > YRES ) {
+    r->x0 = r->y0 = 0;
+    r->x1 = r->y1 = -1;
+    return;
+  }
+  r->x0 = x0 < -1 ? -1 : (int)floor(x0) - 1;
+  r->y0 = y0 < -1 ? -1 : (int)floor(y0) - 1;
+  r->x1 = x1 > XRES ? XRES : (int)ceil(x1) + 1;
+  r->y1 = y1 > YRES ? YRES : (int)ceil(y1) + 1;
+}
+
+/*======== int tiles_of() ==========
+Inputs:   struct rect *r
+          int *tiles
+Returns: 0 if r is empty or off the screen
+
+Sets tiles to the first and last tile columns and rows r covers
+====================*/
+static int tiles_of( struct rect *r, int *tiles ) {
+
+  int x0 = r->x0 < 0 ? 0 : r->x0;
+  int y0 = r->y0 < 0 ? 0 : r->y0;
+  int x1 = r->x1 > XRES - 1 ? XRES - 1 : r->x1;
+  int y1 = r->y1 > YRES - 1 ? YRES - 1 : r->y1;
+
+  if ( x0 > x1 || y0 > y1 )
+    return 0;
+  tiles[0] = x0 / DRAW_TILE;
+  tiles[1] = y0 / DRAW_TILE;
+  tiles[2] = x1 / DRAW_TILE;
+  tiles[3] = y1 / DRAW_TILE;
+  return 1;
+}
+
+static void mark_rect( struct program *p, struct rect *r ) {
+
+  int t[4], tx, ty;
+
+  if ( !tiles_of(r, t) )
+    return;
+  for (ty=t[1]; ty <= t[3]; ty++)
+    for (tx=t[0]; tx <= t[2]; tx++)
+      p->dirty[ty * TILES_X + tx] = 1;
+}
+
+static int rect_dirty( struct program *p, struct rect *r ) {
+
+  int t[4], tx, ty;
+
+  if ( !tiles_of(r, t) )
+    return 0;
+  for (ty=t[1]; ty <= t[3]; ty++)
+    for (tx=t[0]; tx <= t[2]; tx++)
+      if ( p->dirty[ty * TILES_X + tx] )
+	return 1;
+  return 0;
+}
+
+static void transform_points( struct program *p, struct matrix *coords,
+			      struct matrix *points ) {
+  if ( p->camera )
+    matrix_mult_project(coords, points);
+  else
+    matrix_mult(coords, points);
+}
+
+/*======== void shape_rect() ==========
+Inputs:   struct program *p
+          struct shape_state *sh
+          union word *instr
+          struct matrix **coords
+          struct matrix *tmp
+          struct matrix *end
+Returns:
+
+Sets sh->r to screen bounds that hold everything the shape at
+instr draws against coords, without generating it: the corners
+of a box around the shape in its own coordinates are
+transformed, and anything inside it lands inside their bounds.
+If a corner is too close to the camera to project, the whole
+screen is taken. Lines are bound by their ends, and draw
+nothing if either can't be projected.
+====================*/
+static void shape_rect( struct program *p, struct shape_state *sh,
+			union word *instr, struct matrix **coords,
+			struct matrix *tmp, struct matrix *end ) {
+
+  struct mesh *m;
+  double lo[3], hi[3], d;
+  int c, i;
+
+  if ( instr[0].i == BC_LINE ) {
+    add_point(tmp, instr[3].d, instr[4].d, instr[5].d);
+    add_point(end, instr[6].d, instr[7].d, instr[8].d);
+    transform_points(p, coords[0], tmp);
+    transform_points(p, coords[1], end);
+    if ( tmp->m[3][0] != 0 && end->m[3][0] != 0 ) {
+      add_point(tmp, end->m[0][0], end->m[1][0], end->m[2][0]);
+      points_rect(tmp, &sh->r);
+    }
+    else {
+      sh->r.x0 = sh->r.y0 = 0;
+      sh->r.x1 = sh->r.y1 = -1;
+    }
+    tmp->lastcol = 0;
+    end->lastcol = 0;
+    return;
+  }
+
+  switch (instr[0].i) {
+  case BC_SPHERE:
+  case BC_TORUS:
+    d = fabs(instr[6].d);
+    if ( instr[0].i == BC_TORUS )
+      d+= fabs(instr[7].d);
+    for (i=0; i < 3; i++) {
+      lo[i] = instr[3 + i].d - d;
+      hi[i] = instr[3 + i].d + d;
+    }
+    break;
+  case BC_BOX:
+    //the box runs from x, y, z to x + w, y - h, z - d
+    for (i=0; i < 3; i++) {
+      d = instr[3 + i].d + (i ? -instr[6 + i].d : instr[6].d);
+      lo[i] = fmin(instr[3 + i].d, d);
+      hi[i] = fmax(instr[3 + i].d, d);
+    }
+    break;
+  case BC_MESH:
+    m = (struct mesh *)instr[3].p;
+    if ( m->num_vertices == 0 ) {
+      sh->r.x0 = sh->r.y0 = 0;
+      sh->r.x1 = sh->r.y1 = -1;
+      return;
+    }
+    //the vertices don't change, so this is only worked out once
+    if ( !sh->have_box ) {
+      for (i=0; i < 3; i++)
+	sh->lo[i] = sh->hi[i] = m->vertices[i];
+      for (c=1; c < m->num_vertices; c++)
+	for (i=0; i < 3; i++) {
+	  sh->lo[i] = fmin(sh->lo[i], m->vertices[3 * c + i]);
+	  sh->hi[i] = fmax(sh->hi[i], m->vertices[3 * c + i]);
+	}
+      sh->have_box = 1;
+    }
+    memcpy(lo, sh->lo, sizeof(lo));
+    memcpy(hi, sh->hi, sizeof(hi));
+    break;
+  }
+
+  for (c=0; c < 8; c++)
+    add_point(tmp, c & 1 ? hi[0] : lo[0], c & 2 ? hi[1] : lo[1],
+	      c & 4 ? hi[2] : lo[2]);
+  transform_points(p, coords[0], tmp);
+  for (c=0; c < 8 && tmp->m[3][c] != 0; c++)
+    ;
+  if ( c < 8 ) {
+    sh->r.x0 = sh->r.y0 = 0;
+    sh->r.x1 = XRES - 1;
+    sh->r.y1 = YRES - 1;
+  }
+  else
+    points_rect(tmp, &sh->r);
+  tmp->lastcol = 0;
+}
+
+/*======== int skip_shape() ==========
+Inputs:   struct program *p
+          int n
+          union word *instr
+          struct stack *systems
+          struct matrix *tmp
+          struct matrix *end
+Returns: 1 if run_code shouldn't draw the shape at instr,
+         the nth shape in the code it runs
+
+In FRAME_PLAN mode, nothing is drawn: the shape is marked as
+changed if the matrices it is drawn against aren't the ones
+of the last frame planned, and then its old and new bounds
+go into p->dirty. In FRAME_REDRAW mode, a changed shape is
+drawn whole, and any other only over the dirty tiles (through
+draw_mask), if it touches one at all.
+====================*/
+static int skip_shape( struct program *p, int n, union word *instr,
+		       struct stack *systems, struct matrix *tmp,
+		       struct matrix *end ) {
+
+  struct shape_state *sh = p->shapes + n;
+  struct matrix *coords[2];
+  int ends, i, r;
+
+  draw_mask = NULL;
+  if ( p->frame_mode == FRAME_FULL )
+    return 0;
+
+  if ( p->frame_mode == FRAME_REDRAW ) {
+    if ( sh->changed )
+      return 0;
+    if ( !rect_dirty(p, &sh->r) )
+      return 1;
+    draw_mask = p->dirty;
+    return 0;
+  }
+
+  if ( instr[0].i == BC_LINE ) {
+    coords[0] = shape_coords(instr[1].p, systems);
+    coords[1] = shape_coords(instr[2].p, systems);
+    ends = 2;
+  }
+  else {
+    coords[0] = shape_coords(instr[2].p, systems);
+    ends = 1;
+  }
+
+  sh->changed = !sh->drawn;
+  for (i=0; i < ends; i++)
+    for (r=0; r < 4; r++)
+      if ( memcmp(sh->m[i][r], coords[i]->m[r], sizeof(sh->m[i][r])) ) {
+	memcpy(sh->m[i][r], coords[i]->m[r], sizeof(sh->m[i][r]));
+	sh->changed = 1;
+      }
+  if ( sh->changed ) {
+    if ( sh->drawn )
+      mark_rect(p, &sh->r);
+    shape_rect(p, sh, instr, coords, tmp, end);
+    mark_rect(p, &sh->r);
+    sh->drawn = 1;
+  }
+  return 1;
+}
+
+/*======== void draw_shape() ==========
+Inputs:   struct program *p
+          struct matrix *polygons
+          struct matrix *coords
+          struct constants *k
+          screen s
+          zbuffer zb
+Returns:
+
+Transforms polygons against coords and draws them the way the
+program is shaded, then empties polygons
+====================*/
+static void draw_shape( struct program *p, struct matrix *polygons,
+			struct matrix *coords, struct constants *k,
+			screen s, zbuffer zb ) {
+
+  color c;
+
+  if ( p->camera )
+    matrix_mult_project(coords, polygons);
+  else
+    matrix_mult(coords, polygons);
+  shrink_points(p, polygons);
+
+  if ( p->shading == SHADE_WIREFRAME ) {
+    c.red = 0;
+    c.green = 255;
+    c.blue = 0;
+    draw_polygons(polygons, s, zb, c, p->step);
+  }
+  else if ( p->shading == SHADE_FLAT )
+    draw_polygons_flat(polygons, s, zb, p->lights, p->num_lights,
+		       p->ambient, k, p->step);
+  polygons->lastcol = 0;
+}
+
+/*======== void transform() ==========
+Inputs:   struct stack *systems
+          struct matrix *t
+Returns:
+
+Multiplies the top of systems by t, then frees t
+====================*/
+static void transform( struct stack *systems, struct matrix *t ) {
+
+  matrix_mult(peek(systems), t);
+  copy_matrix(t, peek(systems));
+  free_matrix(t);
+}
+
+/*
+  What split_program knows about a coordinate system: whether
+  an instruction has saved it so far, and whether the last
+  matrix saved can change between frames.
+*/
+struct cs_state {
+  struct coord_system *cs;
+  char saved;
+  char animated;
+};
+
+static struct cs_state * find_cs( struct cs_state *states, int *n,
+				  struct coord_system *cs ) {
+  int i;
+
+  for (i=0; i < *n; i++)
+    if ( states[i].cs == cs )
+      return states + i;
+  states[*n].cs = cs;
+  states[*n].saved = states[*n].animated = 0;
+  return states + (*n)++;
+}
+
+/*======== char cs_animated() ==========
+Inputs:   struct cs_state *states
+          int *n
+          struct coord_system *cs
+          char top
+Returns: Whether a shape drawn against cs (with top telling if
+         the top of the stack is animated) can change between
+         frames
+====================*/
+static char cs_animated( struct cs_state *states, int *n,
+			 struct coord_system *cs, char top ) {
+
+  struct cs_state *st;
+
+  if ( cs == NULL )
+    return top;
+  st = find_cs(states, n, cs);
+  if ( st->saved )
+    return st->animated;
+  return top;
+}
+
+/*======== int split_program() ==========
+Inputs:   struct program *p
+          char *animated
+Returns: 1 if p was split, 0 if it can't be
+
+animated has a flag for each knob slot that changes between
+frames. The stack is tracked through the code: a level becomes
+animated when a transform with an animated knob is applied to
+it, and push copies the flag. A shape is animated if the matrix
+it is drawn against is, and every other shape goes in
+static_code. Each shape in animated_code gets a shape_state for
+plan_frame.
+
+Code that saves or displays the image partway through isn't
+split, since the static shapes would show up too early.
+====================*/
+int split_program( struct program *p, char *animated ) {
+
+  union word *code = p->code;
+  union word *out_static, *out_animated;
+  struct cs_state *states;
+  char *levels;
+  int num_states = 0, top = 0;
+  int pc, opcode, len, knob;
+  char dyn;
+
+  for (pc=0; code[pc].i != BC_END; pc+= instr_length[code[pc].i])
+    if ( code[pc].i == BC_SAVE || code[pc].i == BC_DISPLAY )
+      return 0;
+
+  levels = (char *)calloc(p->length + 1, 1);
+  states = (struct cs_state *)calloc(p->length + 1, sizeof(struct cs_state));
+  out_static = (union word *)malloc(p->length * sizeof(union word));
+  out_animated = (union word *)malloc(p->length * sizeof(union word));
+  p->static_code = out_static;
+  p->animated_code = out_animated;
+
+  for (pc=0; (opcode = code[pc].i) != BC_END; pc+= len) {
+    len = instr_length[opcode];
+
+    switch (opcode) {
+    case BC_PUSH:
+      levels[top + 1] = levels[top];
+      top++;
+      break;
+    case BC_POP:
+      if ( top > 0 )
+	top--;
+      break;
+    case BC_MOVE:
+    case BC_SCALE:
+    case BC_ROTX:
+    case BC_ROTY:
+    case BC_ROTZ:
+      knob = code[pc + 1].i;
+      if ( knob >= 0 && animated[knob] )
+	levels[top] = 1;
+      break;
+    case BC_SAVE_COORDS:
+      {
+	struct cs_state *st = find_cs(states, &num_states, code[pc + 1].p);
+	st->saved = 1;
+	st->animated = levels[top];
+      }
+      break;
+    }
+
+    if ( opcode == BC_SPHERE || opcode == BC_TORUS ||
+	 opcode == BC_BOX || opcode == BC_MESH ) {
+      dyn = cs_animated(states, &num_states, code[pc + 2].p, levels[top]);
+    }
+    else if ( opcode == BC_LINE ) {
+      dyn = cs_animated(states, &num_states, code[pc + 1].p, levels[top]) |
+	cs_animated(states, &num_states, code[pc + 2].p, levels[top]);
+    }
+    else {
+      //not a shape, both parts need it
+      memcpy(out_static, code + pc, len * sizeof(union word));
+      memcpy(out_animated, code + pc, len * sizeof(union word));
+      out_static+= len;
+      out_animated+= len;
+      continue;
+    }
+
+    if ( dyn ) {
+      memcpy(out_animated, code + pc, len * sizeof(union word));
+      out_animated+= len;
+      p->num_shapes++;
+    }
+    else {
+      memcpy(out_static, code + pc, len * sizeof(union word));
+      out_static+= len;
+    }
+  }
+  out_static->i = BC_END;
+  out_animated->i = BC_END;
+  p->shapes = (struct shape_state *)calloc(p->num_shapes + 1, sizeof(struct shape_state));
+  p->dirty = (char *)calloc(TILES_X * TILES_Y, 1);
+
+  free(levels);
+  free(states);
+  return 1;
+}
+
+/*======== void run_program() ==========
+Inputs:   struct program *p
+          screen s
+          zbuffer zb
+Returns:
+
+Runs all of p once, drawing into s and zb with the current
+knob values
+====================*/
+void run_program( struct program *p, screen s, zbuffer zb ) {
+
+  run_code(p, p->code, s, zb);
+}
+
+/*======== void run_code() ==========
+Inputs:   struct program *p
+          union word *code
+          screen s
+          zbuffer zb
+Returns:
+
+Runs code, which is p's code or one of its parts
+====================*/
+void run_code( struct program *p, union word *code, screen s, zbuffer zb ) {
+
+  struct stack *systems;
+  struct matrix *tmp, *end;
+  struct coord_system *cs, *cs1;
+  struct constants *k;
+  struct mesh *m;
+  color c;
+  double x, y, z;
+  int pc = 0, opcode, knob, j, shape = 0;
+
+  c.red = 0;
+  c.green = 255;
+  c.blue = 0;
+
+  systems = new_stack();
+  if ( p->camera )
+    copy_matrix(p->camera, peek(systems));
+  tmp = new_matrix(4, 1000);
+  end = new_matrix(4, 1);
+
+  //shapes ahead of a system's save_coord_system use the stack, in
+  //every frame, rather than what an earlier run left in it
+  for (j=0; code[j].i != BC_END; j+= instr_length[code[j].i])
+    if ( code[j].i == BC_SAVE_COORDS )
+      ((struct coord_system *)code[j + 1].p)->source = -1;
+
+  while ( (opcode = code[pc].i) != BC_END && !p->cancel ) {
+    pc++;
+
+    switch (opcode) {
+
+    case BC_PUSH:
+      push(systems);
+      break;
+    case BC_POP:
+      pop(systems);
+      break;
+
+    case BC_MOVE:
+    case BC_SCALE:
+      knob = code[pc].i;
+      x = code[pc + 1].d;
+      y = code[pc + 2].d;
+      z = code[pc + 3].d;
+      pc+= 4;
+      if ( knob >= 0 ) {
+	x*= knob_values[knob];
+	y*= knob_values[knob];
+	z*= knob_values[knob];
+      }
+      if ( opcode == BC_MOVE )
+	transform(systems, make_translate(x, y, z));
+      else
+	transform(systems, make_scale(x, y, z));
+      break;
+    case BC_ROTX:
+    case BC_ROTY:
+    case BC_ROTZ:
+      knob = code[pc].i;
+      x = code[pc + 1].d;
+      pc+= 2;
+      if ( knob >= 0 )
+	x*= knob_values[knob];
+      x*= (M_PI / 180);
+      if ( opcode == BC_ROTX )
+	transform(systems, make_rotX(x));
+      else if ( opcode == BC_ROTY )
+	transform(systems, make_rotY(x));
+      else
+	transform(systems, make_rotZ(x));
+      break;
+
+    case BC_SET:
+      set_knob(code[pc].i, code[pc + 1].d);
+      pc+= 2;
+      break;
+    case BC_SETKNOBS:
+      for ( j=0; j < num_knobs; j++ )
+	set_knob(j, code[pc].d);
+      pc++;
+      break;
+
+    case BC_SPHERE:
+      k = (struct constants *)code[pc].p;
+      cs = (struct coord_system *)code[pc + 1].p;
+      if ( !skip_shape(p, shape++, code + pc - 1, systems, tmp, end) ) {
+	add_sphere(tmp, code[pc + 2].d, code[pc + 3].d, code[pc + 4].d,
+		   code[pc + 5].d, p->step);
+	draw_shape(p, tmp, shape_coords(cs, systems), k, s, zb);
+      }
+      pc+= 6;
+      break;
+    case BC_TORUS:
+      k = (struct constants *)code[pc].p;
+      cs = (struct coord_system *)code[pc + 1].p;
+      if ( !skip_shape(p, shape++, code + pc - 1, systems, tmp, end) ) {
+	add_torus(tmp, code[pc + 2].d, code[pc + 3].d, code[pc + 4].d,
+		  code[pc + 5].d, code[pc + 6].d, p->step);
+	draw_shape(p, tmp, shape_coords(cs, systems), k, s, zb);
+      }
+      pc+= 7;
+      break;
+    case BC_BOX:
+      k = (struct constants *)code[pc].p;
+      cs = (struct coord_system *)code[pc + 1].p;
+      if ( !skip_shape(p, shape++, code + pc - 1, systems, tmp, end) ) {
+	add_box(tmp, code[pc + 2].d, code[pc + 3].d, code[pc + 4].d,
+		code[pc + 5].d, code[pc + 6].d, code[pc + 7].d);
+	draw_shape(p, tmp, shape_coords(cs, systems), k, s, zb);
+      }
+      pc+= 8;
+      break;
+    case BC_MESH:
+      k = (struct constants *)code[pc].p;
+      cs = (struct coord_system *)code[pc + 1].p;
+      m = (struct mesh *)code[pc + 2].p;
+      if ( skip_shape(p, shape++, code + pc - 1, systems, tmp, end) ) {
+	pc+= 3;
+	break;
+      }
+      pc+= 3;
+      //stream the mesh through the pipeline a batch at a time
+      for (j=0; j < m->num_triangles; j+= MESH_BATCH) {
+	add_mesh(tmp, m, j, MESH_BATCH);
+	draw_shape(p, tmp, shape_coords(cs, systems), k, s, zb);
+      }
+      break;
+
+    case BC_LINE:
+      //each end is transformed against its own coordinate system
+      cs = (struct coord_system *)code[pc].p;
+      cs1 = (struct coord_system *)code[pc + 1].p;
+      if ( skip_shape(p, shape++, code + pc - 1, systems, tmp, end) ) {
+	pc+= 8;
+	break;
+      }
+      add_point(tmp, code[pc + 2].d, code[pc + 3].d, code[pc + 4].d);
+      add_point(end, code[pc + 5].d, code[pc + 6].d, code[pc + 7].d);
+      pc+= 8;
+      if ( p->camera ) {
+	matrix_mult_project(shape_coords(cs, systems), tmp);
+	matrix_mult_project(shape_coords(cs1, systems), end);
+      }
+      else {
+	matrix_mult(shape_coords(cs, systems), tmp);
+	matrix_mult(shape_coords(cs1, systems), end);
+      }
+      //an end behind the camera can't be drawn
+      if ( tmp->m[3][0] != 0 && end->m[3][0] != 0 ) {
+	add_point(tmp, end->m[0][0], end->m[1][0], end->m[2][0]);
+	shrink_points(p, tmp);
+	draw_lines(tmp, s, zb, c);
+      }
+      tmp->lastcol = 0;
+      end->lastcol = 0;
+      break;
+
+    case BC_SAVE_COORDS:
+      cs = (struct coord_system *)code[pc].p;
+      save_coord_system(cs, peek(systems), code[pc + 1].i);
+      pc+= 2;
+      break;
+
+    case BC_SAVE:
+      if ( !p->skip_output )
+	save_extension(s, (char *)code[pc].p);
+      pc++;
+      break;
+    case BC_DISPLAY:
+      if ( !p->skip_output )
+	display(s);
+      break;
+    }
+  }
+
+  draw_mask = NULL;
+  free_stack(systems);
+  free_matrix(tmp);
+  free_matrix(end);
+}
+
+/*======== void plan_frame() ==========
+Inputs:   struct program *p
+Returns:
+
+Goes through p's animated_code with the current knob values
+without drawing anything, to find the shapes that moved since
+the last frame planned. Afterwards p->dirty has the tiles they
+covered then and cover now: restoring those from the static
+layer and calling redraw_frame turns the last frame drawn into
+this one.
+====================*/
+void plan_frame( struct program *p ) {
+
+  memset(p->dirty, 0, TILES_X * TILES_Y);
+  p->frame_mode = FRAME_PLAN;
+  run_code(p, p->animated_code, NULL, NULL);
+  p->frame_mode = FRAME_FULL;
+}
+
+/*======== void redraw_frame() ==========
+Inputs:   struct program *p
+          screen s
+          zbuffer zb
+Returns:
+
+Draws what plan_frame found has to be drawn again into s and
+zb: the shapes that changed, and the parts of the others over
+the dirty tiles. They are drawn in order, so where shapes meet
+at the same depth the same one wins as in a full frame.
+====================*/
+void redraw_frame( struct program *p, screen s, zbuffer zb ) {
+
+  p->frame_mode = FRAME_REDRAW;
+  run_code(p, p->animated_code, s, zb);
+  p->frame_mode = FRAME_FULL;
+}
+
+/*======== int run_progressive() ==========
+Inputs:   struct program *p
+          screen s
+          zbuffer zb
+Returns: 0 once s holds the full quality image, -1 if p->cancel
+         was set first
+
+Draws all of p in PREVIEW_PASSES passes from coarse to full
+quality, clearing s and zb before each. Preview passes draw at
+1/shrink of the resolution (with the lights moved to match)
+and are enlarged to fill the screen and published to the
+shared memory display; only the last pass saves and displays
+what the script asks for (unless p->skip_output is set). With
+no shared memory display there is nowhere to show previews
+without waiting on a display window, so only the last pass is
+drawn.
+
+Setting p->cancel (e.g. from another thread when a knob
+changes) abandons the passes left. It is up to the caller to
+clear it beforehand.
+====================*/
+int run_progressive( struct program *p, screen s, zbuffer zb ) {
+
+  int shrink[PREVIEW_PASSES] = PREVIEW_SHRINK;
+  double step_scale[PREVIEW_PASSES] = PREVIEW_STEP_SCALE;
+  double base_step = p->step;
+  double (*lights)[3];
+  int skip = p->skip_output;
+  int pass, preview, i, j;
+
+  lights = malloc((p->num_lights + 1) * sizeof(lights[0]));
+  for (i=0; i < p->num_lights; i++)
+    for (j=0; j < 3; j++)
+      lights[i][j] = p->lights[i][3 + j];
+
+  pass = shared_display_open() ? 0 : PREVIEW_PASSES - 1;
+  for (; pass < PREVIEW_PASSES && !p->cancel; pass++) {
+    preview = pass < PREVIEW_PASSES - 1;
+    p->skip_output = skip || preview;
+    p->shrink = shrink[pass];
+    p->step = base_step * step_scale[pass];
+    for (i=0; i < p->num_lights; i++)
+      for (j=0; j < 3; j++)
+	p->lights[i][3 + j] = lights[i][j] / p->shrink;
+
+    clear_screen(s);
+    clear_zbuffer(zb);
+    run_code(p, p->code, s, zb);
+    if ( preview && !p->cancel ) {
+      enlarge_screen(s, p->shrink);
+      publish_screen(s, -1);
+    }
+  }
+
+  for (i=0; i < p->num_lights; i++)
+    for (j=0; j < 3; j++)
+      p->lights[i][3 + j] = lights[i][j];
+  free(lights);
+  p->step = base_step;
+  p->skip_output = skip;
+  p->shrink = 1;
+  return p->cancel ? -1 : 0;
+}
+
+/*======== void free_program() ==========
+Inputs:   struct program *p
+Returns:
+
+Frees p and everything compile_ops made for it
+====================*/
+void free_program( struct program *p ) {
+
+  free2DArray(p->lights, p->num_lights);
+  if ( p->camera )
+    free_matrix(p->camera);
+  free(p->code);
+  free(p->static_code);
+  free(p->animated_code);
+  free(p->shapes);
+  free(p->dirty);
+  free(p);
+}
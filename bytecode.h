@@ -0,0 +1,145 @@
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+#include <signal.h>
+
+#include "matrix.h"
+#include "ml6.h"
+#include "symtab.h"
+#include "mesh.h"
+
+/*
+  The part of a script that is run every frame, compiled from
+  op[] by compile_ops. The code is a flat array of words, each
+  instruction an opcode followed by its operands inline:
+
+    BC_PUSH, BC_POP, BC_DISPLAY
+    BC_MOVE, BC_SCALE           knob x y z
+    BC_ROTX, BC_ROTY, BC_ROTZ   knob degrees
+    BC_SET                      knob value
+    BC_SETKNOBS                 value
+    BC_SPHERE                   constants cs x y z r
+    BC_TORUS                    constants cs x y z r0 r1
+    BC_BOX                      constants cs x y z width height depth
+    BC_MESH                     constants cs mesh
+    BC_LINE                     cs0 cs1 x0 y0 z0 x1 y1 z1
+    BC_SAVE_COORDS              cs id
+    BC_SAVE                     filename
+    BC_END
+
+  knob is a slot in knob_values (-1 for none), constants a
+  struct constants * (never NULL), cs a struct coord_system *
+  (NULL to use the origin stack) and mesh a struct mesh *.
+  id is the index of the save_coord_system instruction in code,
+  which stays the same when the code is split.
+
+  For animations, split_program divides code into a static part,
+  drawing only the shapes that look the same in every frame, and
+  an animated part drawing the rest (either may have no shapes).
+  Both keep every instruction that isn't a shape, so the stack
+  and coordinate systems are the same in each.
+*/
+#define BC_END 0
+#define BC_PUSH 1
+#define BC_POP 2
+#define BC_MOVE 3
+#define BC_SCALE 4
+#define BC_ROTX 5
+#define BC_ROTY 6
+#define BC_ROTZ 7
+#define BC_SET 8
+#define BC_SETKNOBS 9
+#define BC_SPHERE 10
+#define BC_TORUS 11
+#define BC_BOX 12
+#define BC_MESH 13
+#define BC_LINE 14
+#define BC_SAVE_COORDS 15
+#define BC_SAVE 16
+#define BC_DISPLAY 17
+
+//how primitives are drawn
+#define SHADE_NONE 0
+#define SHADE_WIREFRAME 1
+#define SHADE_FLAT 2
+
+/*
+  Passes of run_progressive, coarsest first: each draws at
+  1/shrink of the resolution with step_scale times the step.
+  The last one is the full quality image.
+*/
+#define PREVIEW_PASSES 4
+#define PREVIEW_SHRINK { 4, 2, 1, 1 }
+#define PREVIEW_STEP_SCALE { 10, 5, 2, 1 }
+
+//screen space bounds, inclusive
+struct rect {
+  int x0, y0, x1, y1;
+};
+
+/*
+  What plan_frame knows about each shape in animated_code from
+  the last frame it planned.
+*/
+struct shape_state {
+  double m[2][4][4]; /* matrices it was drawn against (lines have two) */
+  double lo[3], hi[3]; /* a mesh's bounds in its own coordinates */
+  char have_box;
+  char drawn, changed;
+  struct rect r; /* screen bounds, empty when x1 < x0 */
+};
+
+//what run_code does with the shapes in animated_code
+#define FRAME_FULL 0   /* draw them all */
+#define FRAME_PLAN 1   /* work out which changed, draw nothing */
+#define FRAME_REDRAW 2 /* draw the ones plan_frame left on dirty tiles */
+
+union word {
+  int i;
+  double d;
+  void *p;
+};
+
+struct program {
+  union word *code;
+  int length, size;
+  union word *static_code;   /* NULL until split_program */
+  union word *animated_code;
+
+  //everything the script sets up once, resolved at compile time
+  int shading;
+  double step;
+  double **lights; /* r g b x y z of each light */
+  int num_lights;
+  color ambient;
+  struct matrix *camera; /* view-projection, or NULL */
+
+  //one state for each shape in animated_code, and the tiles
+  //(indexed like draw_mask) the last plan_frame found changed
+  int frame_mode;
+  struct shape_state *shapes;
+  int num_shapes;
+  char *dirty;
+
+  //shapes are scaled down by shrink for run_progressive's
+  //preview passes, and save and display are skipped while
+  //skip_output is set (during those passes and in server mode)
+  int shrink;
+  int skip_output;
+  //setting cancel (from a signal handler or another thread, as
+  //the server does when the knobs change under a progressive
+  //render) stops run_code and run_progressive at the next
+  //instruction
+  volatile sig_atomic_t cancel;
+};
+
+struct program * compile_ops();
+int split_program( struct program *p, char *animated );
+void run_program( struct program *p, screen s, zbuffer zb );
+void run_code( struct program *p, union word *code, screen s, zbuffer zb );
+void plan_frame( struct program *p );
+void redraw_frame( struct program *p, screen s, zbuffer zb );
+int run_progressive( struct program *p, screen s, zbuffer zb );
+void free_program( struct program *p );
+
+#endif
@@ -12,10 +12,19 @@ for red, green and blue respectively
 #include <string.h>
 #include <errno.h>
 #include <limits.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 
 #include "ml6.h"
 #include "display.h"
 
+//the shared memory display, if open_shared_display was called
+static struct shared_header *shared = NULL;
+static size_t shared_size;
+
+
+//the tiles drawing is limited to, or NULL for the whole screen
+char *draw_mask = NULL;
 
 /*======== void plot() ==========
 Inputs:   screen s
@@ -25,22 +34,22 @@ Inputs:   screen s
          int y 
 Returns: 
 Sets the color at pixel x, y to the color represented by c
-Note that s[0][0] will be the upper left hand corner 
-of the screen. 
-If you wish to change this behavior, you can change the indicies
-of s that get set. For example, using s[x][YRES-1-y] will have
-pixel 0, 0 located at the lower left corner of the screen
+Note that s is stored row by row, so s[y][x] is pixel x of
+row y and s[0][0] is the upper left hand corner of the screen.
+Using s[YRES-1-y][x] puts pixel 0, 0 at the lower left corner
+of the screen
 
 jdyrlandweaver
 ====================*/
 void plot( screen s, zbuffer zb, color c, int x, int y, double z) {
   int newy = YRES - 1 - y;
-  if ( x >= 0 && x < XRES && newy >=0 && newy < YRES )
+  if ( x >= 0 && x < XRES && newy >=0 && newy < YRES &&
+       ( !draw_mask || draw_mask[(y / DRAW_TILE) * TILES_X + x / DRAW_TILE] ) )
   {
-    if(zb[x][newy] <= z)
+    if(zb[newy][x] <= z)
     {
-      zb[x][newy] = z;
-      s[x][newy] = c;
+      zb[newy][x] = z;
+      s[newy][x] = c;
     }
   }
 }
@@ -69,7 +78,7 @@ void clear_screen( screen s ) {
 
   for ( y=0; y < YRES; y++ )
     for ( x=0; x < XRES; x++)      
-      s[x][y] = c;
+      s[y][x] = c;
 }
 
 /*======== void clear_zbuffer() ==========
@@ -85,7 +94,85 @@ void clear_zbuffer( zbuffer zb ) {
 
   for ( y=0; y < YRES; y++ )
     for ( x=0; x < XRES; x++)      
-      zb[x][y] = LONG_MIN;
+      zb[y][x] = LONG_MIN;
+}
+
+/*======== void copy_region() ==========
+Inputs:   screen from
+          zbuffer zfrom
+          screen to
+          zbuffer zto
+          int x0, int y0, int x1, int y1
+Returns: 
+Copies the colors and depths of the pixels with x0 <= x <= x1
+and y0 <= y <= y1 from one screen (and zbuffer) to another.
+The rectangle is clipped to the screen.
+====================*/
+void copy_region( screen from, zbuffer zfrom, screen to, zbuffer zto,
+		  int x0, int y0, int x1, int y1 ) {
+
+  int y, row;
+
+  if ( x0 < 0 ) x0 = 0;
+  if ( y0 < 0 ) y0 = 0;
+  if ( x1 > XRES - 1 ) x1 = XRES - 1;
+  if ( y1 > YRES - 1 ) y1 = YRES - 1;
+  if ( x0 > x1 )
+    return;
+
+  for ( y=y0; y <= y1; y++ ) {
+    row = YRES - 1 - y;
+    memcpy( to[row] + x0, from[row] + x0, (x1 - x0 + 1) * sizeof(color) );
+    memcpy( zto[row] + x0, zfrom[row] + x0, (x1 - x0 + 1) * sizeof(double) );
+  }
+}
+
+/*======== void copy_tiles() ==========
+Inputs:   screen from
+          zbuffer zfrom
+          screen to
+          zbuffer zto
+          char *tiles
+Returns: 
+Copies the colors and depths of the tiles set in tiles (see
+draw_mask) from one screen (and zbuffer) to another, a run
+of neighbouring tiles at a time.
+====================*/
+void copy_tiles( screen from, zbuffer zfrom, screen to, zbuffer zto,
+		 char *tiles ) {
+
+  int tx, ty, run;
+
+  for ( ty=0; ty < TILES_Y; ty++ )
+    for ( tx=0; tx < TILES_X; tx = run ) {
+      for ( run=tx; run < TILES_X && tiles[ty * TILES_X + run]; run++ )
+	;
+      if ( run > tx )
+	copy_region( from, zfrom, to, zto, tx * DRAW_TILE, ty * DRAW_TILE,
+		     run * DRAW_TILE - 1, (ty + 1) * DRAW_TILE - 1 );
+      else
+	run++;
+    }
+}
+
+/*======== void enlarge_screen() ==========
+Inputs:   screen s
+          int n
+Returns: 
+Scales the image in the lower left XRES/n by YRES/n corner of
+s up to fill all of s, repeating each pixel n times in each
+direction. Pixels are filled from the top right down, so each
+one is read before it can be overwritten.
+====================*/
+void enlarge_screen( screen s, int n ) {
+
+  int x, y;
+
+  if ( n <= 1 )
+    return;
+  for ( y=YRES-1; y >= 0; y-- )
+    for ( x=XRES-1; x >= 0; x-- )
+      s[YRES - 1 - y][x] = s[YRES - 1 - y / n][x / n];
 }
 
 /*======== void save_ppm() ==========
@@ -108,16 +195,16 @@ void save_ppm( screen s, char *file) {
   for ( y=0; y < YRES; y++ ) {
     for ( x=0; x < XRES; x++) 
       
-      fprintf(f, "%d %d %d ", s[x][y].red, s[x][y].green, s[x][y].blue);
+      fprintf(f, "%d %d %d ", s[y][x].red, s[y][x].green, s[y][x].blue);
     fprintf(f, "\n");
   }
   fclose(f);
 }
  
-/*======== void save_extension() ==========
+/*======== int save_extension() ==========
 Inputs:   screen s
          char *file 
-Returns: 
+Returns: 0 on success, -1 if convert failed
 Saves the screen stored in s to the filename represented
 by file. 
 If the extension for file is an image format supported
@@ -127,7 +214,7 @@ that format.
 02/12/10 09:14:46
 jdyrlandweaver
 ====================*/
-void save_extension( screen s, char *file) {
+int save_extension( screen s, char *file) {
   
   int x, y;
   FILE *f;
@@ -136,21 +223,24 @@ void save_extension( screen s, char *file) {
   sprintf(line, "convert - %s", file);
 
   f = popen(line, "w");
+  if ( f == NULL )
+    return -1;
   fprintf(f, "P3\n%d %d\n%d\n", XRES, YRES, MAX_COLOR);
   for ( y=0; y < YRES; y++ ) {
     for ( x=0; x < XRES; x++) 
       
-      fprintf(f, "%d %d %d ", s[x][y].red, s[x][y].green, s[x][y].blue);
+      fprintf(f, "%d %d %d ", s[y][x].red, s[y][x].green, s[y][x].blue);
     fprintf(f, "\n");
   }
-  pclose(f);
+  return pclose(f) == 0 ? 0 : -1;
 }
 
 
 /*======== void display() ==========
 Inputs:   screen s 
 Returns: 
-Will display the screen s on your monitor
+Will display the screen s on your monitor, or publish it
+to the shared memory display if one is open
 
 02/12/10 09:16:30
 jdyrlandweaver
@@ -160,13 +250,18 @@ void display( screen s) {
   int x, y;
   FILE *f;
 
+  if ( shared ) {
+    publish_screen(s, -1);
+    return;
+  }
+
   f = popen("display", "w");
 
   fprintf(f, "P3\n%d %d\n%d\n", XRES, YRES, MAX_COLOR);
   for ( y=0; y < YRES; y++ ) {
     for ( x=0; x < XRES; x++) 
       
-      fprintf(f, "%d %d %d ", s[x][y].red, s[x][y].green, s[x][y].blue);
+      fprintf(f, "%d %d %d ", s[y][x].red, s[y][x].green, s[y][x].blue);
     fprintf(f, "\n");
   }
   pclose(f);
@@ -187,3 +282,122 @@ void make_animation( char * name ) {
     printf("e: %d errno: %d: %s\n", e, errno, strerror(errno));
   }
 }
+
+/*======== void screen_to_rgb() ==========
+Inputs:   screen s
+          unsigned char *rgb
+Returns:
+
+Writes s to rgb as XRES * YRES RGB pixels, one byte per
+channel (clamped to 0-MAX_COLOR), top row first
+====================*/
+void screen_to_rgb( screen s, unsigned char *rgb ) {
+
+  int x, y, v;
+
+  for ( y=0; y < YRES; y++ )
+    for ( x=0; x < XRES; x++ ) {
+      v = s[y][x].red;
+      *rgb++ = v < 0 ? 0 : v > MAX_COLOR ? MAX_COLOR : v;
+      v = s[y][x].green;
+      *rgb++ = v < 0 ? 0 : v > MAX_COLOR ? MAX_COLOR : v;
+      v = s[y][x].blue;
+      *rgb++ = v < 0 ? 0 : v > MAX_COLOR ? MAX_COLOR : v;
+    }
+}
+
+/*======== int open_shared_display() ==========
+Inputs:   char *name
+Returns: 0 on success, -1 on failure
+
+Creates (or reuses) the shared memory object name and maps
+it, so that display and publish_screen write there. The
+object is left in place afterwards for readers that attach
+late; remove it with shm_unlink (/dev/shm/name on Linux).
+====================*/
+int open_shared_display( char *name ) {
+
+  int fd;
+  void *map;
+  char path[256];
+
+  //shared memory names start with a single /
+  snprintf(path, sizeof(path), "%s%s", name[0] == '/' ? "" : "/", name);
+  name = path;
+  shared_size = sizeof(struct shared_header) + (size_t)XRES * YRES * 3;
+  fd = shm_open(name, O_RDWR | O_CREAT, 0644);
+  if ( fd < 0 ) {
+    printf("Error: could not open shared memory %s: %s\n", name, strerror(errno));
+    return -1;
+  }
+  if ( ftruncate(fd, shared_size) < 0 ) {
+    printf("Error: could not size shared memory %s\n", name);
+    close(fd);
+    return -1;
+  }
+  map = mmap(NULL, shared_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if ( map == MAP_FAILED ) {
+    printf("Error: could not map shared memory %s\n", name);
+    return -1;
+  }
+
+  shared = (struct shared_header *)map;
+  //an odd sequence while the header is rewritten
+  shared->sequence |= 1;
+  __sync_synchronize();
+  memcpy(shared->magic, SHARED_MAGIC, 4);
+  shared->version = SHARED_VERSION;
+  shared->width = XRES;
+  shared->height = YRES;
+  shared->channels = 3;
+  shared->frame = -1;
+  __sync_synchronize();
+  shared->sequence++;
+  return 0;
+}
+
+/*======== void publish_screen() ==========
+Inputs:   screen s
+          int frame
+Returns:
+
+Copies s into the shared memory display as frame frame,
+bumping the sequence around the write. Does nothing if no
+shared memory display is open.
+====================*/
+void publish_screen( screen s, int frame ) {
+
+  if ( !shared )
+    return;
+  shared->sequence++;
+  __sync_synchronize();
+  screen_to_rgb(s, (unsigned char *)(shared + 1));
+  shared->frame = frame;
+  __sync_synchronize();
+  shared->sequence++;
+}
+
+/*======== int shared_display_open() ==========
+Inputs:
+Returns: 1 if a shared memory display is open, 0 otherwise
+====================*/
+int shared_display_open() {
+
+  return shared != NULL;
+}
+
+/*======== void close_shared_display() ==========
+Inputs:
+Returns:
+
+Unmaps the shared memory display, leaving the object and
+its last image for readers
+====================*/
+void close_shared_display() {
+
+  if ( !shared )
+    return;
+  munmap(shared, shared_size);
+  shared = NULL;
+}
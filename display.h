@@ -3,11 +3,61 @@
 
 #include "ml6.h"
 
+/*
+  Drawing can be limited to some DRAW_TILE pixel square tiles
+  of the screen: while draw_mask is set, plot and draw_span
+  only touch the pixels of tiles set in it. Pixel x, y (with y
+  up, as plot takes it) is in tile x / DRAW_TILE, y / DRAW_TILE,
+  at index ty * TILES_X + tx.
+*/
+#define DRAW_TILE 16
+#define TILES_X ((XRES + DRAW_TILE - 1) / DRAW_TILE)
+#define TILES_Y ((YRES + DRAW_TILE - 1) / DRAW_TILE)
+
+extern char *draw_mask;
+
 void plot( screen s, zbuffer zb, color c, int x, int y, double z);
 void clear_screen( screen s);
 void clear_zbuffer( zbuffer zb );
+void copy_region( screen from, zbuffer zfrom, screen to, zbuffer zto,
+		  int x0, int y0, int x1, int y1 );
+void copy_tiles( screen from, zbuffer zfrom, screen to, zbuffer zto,
+		 char *tiles );
+void enlarge_screen( screen s, int n );
 void save_ppm( screen s, char *file);
-void save_extension( screen s, char *file);
+int save_extension( screen s, char *file);
 void display( screen s);
 void make_animation( char * name );
+void screen_to_rgb( screen s, unsigned char *rgb );
+
+/*
+  Shared memory display: instead of showing images with the
+  display program, they are published into a POSIX shared
+  memory object holding a shared_header followed by height
+  rows of width RGB pixels, one byte per channel, top row
+  first.
+
+  sequence is odd while an image is being written and goes up
+  by 2 for every image, so a reader that sees the same even
+  sequence before and after reading the pixels has a whole
+  image. frame is the animation frame it came from, or -1 for
+  a display command.
+*/
+#define SHARED_MAGIC "MDLS"
+#define SHARED_VERSION 1
+
+struct shared_header {
+  char magic[4];
+  int version;
+  int width;
+  int height;
+  int channels;
+  int frame;
+  volatile unsigned long sequence;
+};
+
+int open_shared_display( char *name );
+void publish_screen( screen s, int frame );
+int shared_display_open();
+void close_shared_display();
 #endif
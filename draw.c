@@ -1,5 +1,10 @@
 #include <stdio.h>
 #include <stdlib.h>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 #include "ml6.h"
 #include "display.h"
@@ -23,130 +28,400 @@ void free2DArray(double ** a, int len)
   free(a);
 }
 
-void swap(double ** a, int i, int j)
+//swaps vertices a and b if a is above b
+static inline void order_pair_y(double * a, double * b)
 {
-  double * temp = a[i];
-  a[i] = a[j];
-  a[j] = temp;
+  if(a[1] > b[1])
+  {
+    double t0 = a[0], t1 = a[1], t2 = a[2];
+    a[0] = b[0]; a[1] = b[1]; a[2] = b[2];
+    b[0] = t0; b[1] = t1; b[2] = t2;
+  }
 }
 
-//sorts points by their y coordinate
-void sortPointsY(double ** vertices, int len)
+/*======== void sort_vertices_y() ==========
+Inputs:   double v[3][3]
+Returns: 
+Sorts the three vertices of a triangle by their y coordinate
+with a fixed three element sorting network, so that v[0] is
+the bottom, v[1] the middle and v[2] the top vertex.
+====================*/
+static inline void sort_vertices_y(double v[3][3])
 {
-  int i, j;
-  for(i = 0; i < len; i++)
+  order_pair_y(v[0], v[1]);
+  order_pair_y(v[1], v[2]);
+  order_pair_y(v[0], v[1]);
+}
+
+/////////////////////////////////////////////Scanline implementations with different shading algorithms/////////////////////////////////////////////
+//how far past the screen edges a triangle may reach before it is clipped
+#define GUARD_BAND 1000
+
+/*======== void fill_triangle() ==========
+Inputs:   double v[3][3]
+          screen s
+          zbuffer zb
+          color c
+          double step
+Returns: 
+Fills in the triangle with vertices v[0], v[1] and v[2] with c.
+The whole triangle setup lives on the stack: the vertices are
+sorted with a sorting network, then the x and z slopes of each
+edge are found once using the reciprocal of its height.
+The left and right edges are then walked by adding their
+per-step deltas, and each span steps z by the dz/dx of the
+triangle's plane. Only the steps that land on a screen row
+are walked.
+====================*/
+static void fill_triangle(double v[3][3], screen s, zbuffer zb, color c, double step)
+{
+  //get points in order
+  sort_vertices_y(v);
+  double * B = v[0]; double * M = v[1]; double * T = v[2];
+
+  //reciprocal heights of each edge, 0 for horizontal edges
+  double invBT = T[1] > B[1] ? 1 / (T[1] - B[1]) : 0;
+  double invBM = M[1] > B[1] ? 1 / (M[1] - B[1]) : 0;
+  double invMT = T[1] > M[1] ? 1 / (T[1] - M[1]) : 0;
+
+  //change in x and z per unit of y along each edge
+  double dxBT = (T[0] - B[0]) * invBT; double dzBT = (T[2] - B[2]) * invBT;
+  double dxBM = (M[0] - B[0]) * invBM; double dzBM = (M[2] - B[2]) * invBM;
+  double dxMT = (T[0] - M[0]) * invMT; double dzMT = (T[2] - M[2]) * invMT;
+
+  //change in z per unit of x, constant over the plane of the triangle
+  double area = (M[0] - B[0]) * (T[1] - B[1]) - (T[0] - B[0]) * (M[1] - B[1]);
+  double dzdx = area != 0 ? ((M[2] - B[2]) * (T[1] - B[1]) - (T[2] - B[2]) * (M[1] - B[1])) / area : 0;
+
+  //skip the steps below the bottom row (y truncates to a row only above -1)
+  double yCurrent = B[1];
+  if(B[1] <= -1) yCurrent = B[1] + (floor((-1 - B[1]) / step) + 1) * step;
+
+  ////////////////////////////Draw////////////////////////////
+  //left travels from B to T, right travels from B to M, then M to T
+  double xLeft = B[0] + dxBT * (yCurrent - B[1]); double zLeft = B[2] + dzBT * (yCurrent - B[1]);
+  double xRight = B[0] + dxBM * (yCurrent - B[1]); double zRight = B[2] + dzBM * (yCurrent - B[1]);
+  double dxLeft = dxBT * step; double dzLeft = dzBT * step;
+  double dxRight = dxBM * step; double dzRight = dzBM * step;
+  double xStart, zStart, xEnd, z;
+  int pastM = 0;
+
+  while(yCurrent <= T[1] && yCurrent < YRES) //stops after the top row. Note that B[1] is never equal to T[1], unless the triangle is degenerate.
   {
-    int swapCount = 0;
-    for(j = 0; j < len - 1; j++)
+    if(!pastM && yCurrent >= M[1])
     {
-      if(vertices[j][1] >= vertices[j + 1][1]) 
-      {
-        swapCount++;
-        swap(vertices, j, j + 1);
-      }
+      //right turns the corner at M
+      pastM = 1;
+      xRight = M[0] + dxMT * (yCurrent - M[1]);
+      zRight = M[2] + dzMT * (yCurrent - M[1]);
+      dxRight = dxMT * step; dzRight = dzMT * step;
     }
-    if(swapCount == 0) break;
+
+    if(xLeft <= xRight) { xStart = xLeft; zStart = zLeft; xEnd = xRight; }
+    else { xStart = xRight; zStart = zRight; xEnd = xLeft; }
+    //depth at the first whole pixel of the span, which must not move toward the viewer
+    z = zStart + dzdx * ((int) xStart - xStart);
+    if(z > zStart) z = zStart;
+    draw_span((int) xStart, (int) xEnd, (int) yCurrent, z, dzdx, s, zb, c);
+
+    yCurrent += step;
+    xLeft += dxLeft; zLeft += dzLeft;
+    xRight += dxRight; zRight += dzRight;
   }
 }
 
-/////////////////////////////////////////////Scanline implementations with different shading algorithms/////////////////////////////////////////////
-void scanline_convert( struct matrix *points, int i, screen s, zbuffer zb, color c, double step) 
+/*======== int clip_polygon() ==========
+Inputs:   double in[][3]
+          int n
+          double out[][3]
+          int axis
+          double bound
+          int keepBelow
+Returns: the number of vertices in out
+
+One Sutherland-Hodgman pass: clips the convex polygon in (n
+vertices) against the line where coordinate axis equals bound,
+keeping the side below it if keepBelow is set and the side above
+it otherwise. z is interpolated along the cut edges.
+====================*/
+static int clip_polygon(double in[][3], int n, double out[][3], int axis, double bound, int keepBelow)
 {
-  int debug = 0;
-
-  double ** vertices = (double **) calloc(3, sizeof(double *));
-
-  //initialize list of points
-  int j, k;
-  for(j = 0; j < 3; j++)
+  int j, k, count = 0;
+  for(j = 0; j < n; j++)
   {
-    vertices[j] = (double *) calloc(3, sizeof(double));
-    for(k = 0; k < 3; k++)
+    double * a = in[j];
+    double * b = in[(j + 1) % n];
+    int aInside = keepBelow ? a[axis] <= bound : a[axis] >= bound;
+    int bInside = keepBelow ? b[axis] <= bound : b[axis] >= bound;
+
+    if(aInside)
+    {
+      for(k = 0; k < 3; k++) out[count][k] = a[k];
+      count++;
+    }
+    if(aInside != bInside)
     {
-      vertices[j][k] = points->m[k][i + j];
+      double t = (bound - a[axis]) / (b[axis] - a[axis]);
+      for(k = 0; k < 3; k++) out[count][k] = a[k] + (b[k] - a[k]) * t;
+      out[count][axis] = bound;
+      count++;
     }
   }
+  return count;
+}
 
-  //get points in order
-  sortPointsY(vertices, 3);
-  double * B = vertices[0]; double * M = vertices[1]; double * T = vertices[2];
+/*======== void scanline_convert() ==========
+Inputs:   struct matrix *points
+          int i
+          screen s
+          zbuffer zb
+          color c
+          double step
+Returns: 
+Fills in the triangle made of points i, i+1 and i+2 with c.
+
+This is also the clipping stage. Triangles entirely off the
+screen are dropped. Triangles that stay within GUARD_BAND pixels
+of the screen are filled directly, since fill_triangle and
+draw_span only walk the rows and columns on the screen. Anything
+larger is clipped to the guard band with Sutherland-Hodgman and
+the resulting polygon is filled as a fan of triangles.
+====================*/
+void scanline_convert( struct matrix *points, int i, screen s, zbuffer zb, color c, double step) 
+{
+  double v[3][3];
+  double xMin, xMax, yMin, yMax;
+  int j;
+  for(j = 0; j < 3; j++)
+  {
+    v[j][0] = points->m[0][i + j];
+    v[j][1] = points->m[1][i + j];
+    v[j][2] = points->m[2][i + j];
+  }
 
-  if(debug) printf("=================================================\n");
-  if(debug) printf("Polygon with vertices: \n");
-  if(debug) printf("B: (%f, %f, %f)\n", B[0], B[1], B[2]);
-  if(debug) printf("M: (%f, %f, %f)\n", M[0], M[1], M[2]);
-  if(debug) printf("T: (%f, %f, %f)\n", T[0], T[1], T[2]);
+  xMin = fmin(v[0][0], fmin(v[1][0], v[2][0])); xMax = fmax(v[0][0], fmax(v[1][0], v[2][0]));
+  yMin = fmin(v[0][1], fmin(v[1][1], v[2][1])); yMax = fmax(v[0][1], fmax(v[1][1], v[2][1]));
+  if(xMax < 0 || xMin >= XRES || yMax <= -1 || yMin >= YRES) return;
 
-  ////////////////////////////Draw////////////////////////////
-  double * left = (double *) calloc(3, sizeof(double)); //left will travel from B to T
-  double * right = (double *) calloc(3, sizeof(double)); //right will travel from B to M, then M to T
+  if(xMin >= -GUARD_BAND && xMax <= XRES + GUARD_BAND && yMin >= -GUARD_BAND && yMax <= YRES + GUARD_BAND)
+  {
+    fill_triangle(v, s, zb, c, step);
+    return;
+  }
 
-  left[0] = right[0] = B[0]; left[1] = right[1] = B[1]; left[2] = right[2] = B[2];
-  double yCurrent = B[1];
+  //each pass can add at most one vertex
+  double a[7][3], b[7][3];
+  int n = 3;
+  n = clip_polygon(v, n, a, 0, -GUARD_BAND, 0);
+  n = clip_polygon(a, n, b, 0, XRES + GUARD_BAND, 1);
+  n = clip_polygon(b, n, a, 1, -GUARD_BAND, 0);
+  n = clip_polygon(a, n, b, 1, YRES + GUARD_BAND, 1);
 
-  while(yCurrent <= T[1]) //Note that B[1] is never equal to T[1], unless the triangle is degenerate.
+  for(j = 1; j < n - 1; j++)
   {
-    //left
-    left[0] = B[0] + (T[0] - B[0]) * (yCurrent - B[1]) / (T[1] - B[1]);
-    left[1] = yCurrent;
-    left[2] = B[2] + (T[2] - B[2]) * (yCurrent - B[1]) / (T[1] - B[1]);
+    double tri[3][3] = {
+      { b[0][0], b[0][1], b[0][2] },
+      { b[j][0], b[j][1], b[j][2] },
+      { b[j + 1][0], b[j + 1][1], b[j + 1][2] }
+    };
+    fill_triangle(tri, s, zb, c, step);
+  }
+}
 
-    if(yCurrent < M[1]) //M[1] > B[1]
+/*======== void depth_span() ==========
+Inputs:   color *colors
+          double *depths
+          int n
+          double z0
+          double dzdx
+          color c
+Returns: 
+Depth tests and writes n contiguous pixels, where pixel k sits
+at depth z0 + k * dzdx. Eight pixels are handled per iteration:
+their depths are compared against the interpolated z in vector
+registers, and the passing lanes get their depth and color
+stored. Uses AVX2 when compiled with it (make SIMD=-mavx2),
+SSE2 otherwise, and a plain loop for the leftover pixels.
+====================*/
+static void depth_span(color * colors, double * depths, int n, double z0, double dzdx, color c)
+{
+  int k = 0;
+
+#if defined(__AVX2__) || defined(__SSE2__)
+  //the color repeated 4 times, so 4 pixels can be filled with 3 stores
+  color pattern[4] = { c, c, c, c };
+#endif
+
+#if defined(__AVX2__)
+  __m256d zStart = _mm256_set1_pd(z0);
+  __m256d zStep = _mm256_set1_pd(dzdx);
+  __m256d offset0 = _mm256_set_pd(3, 2, 1, 0);
+  __m256d offset1 = _mm256_set_pd(7, 6, 5, 4);
+  __m256d eight = _mm256_set1_pd(8);
+  __m128i rgb0 = _mm_loadu_si128((__m128i *) pattern);
+  __m128i rgb1 = _mm_loadu_si128((__m128i *) pattern + 1);
+  __m128i rgb2 = _mm_loadu_si128((__m128i *) pattern + 2);
+  __m256i rgbA = _mm256_set_m128i(rgb1, rgb0);
+  __m256i rgbB = _mm256_set_m128i(rgb0, rgb2);
+  __m256i rgbC = _mm256_set_m128i(rgb2, rgb1);
+
+  for(; k + 8 <= n; k += 8)
+  {
+    __m256d z0v = _mm256_add_pd(zStart, _mm256_mul_pd(zStep, offset0));
+    __m256d z1v = _mm256_add_pd(zStart, _mm256_mul_pd(zStep, offset1));
+    __m256d pass0 = _mm256_cmp_pd(_mm256_loadu_pd(depths + k), z0v, _CMP_LE_OQ);
+    __m256d pass1 = _mm256_cmp_pd(_mm256_loadu_pd(depths + k + 4), z1v, _CMP_LE_OQ);
+    int mask = _mm256_movemask_pd(pass0) | (_mm256_movemask_pd(pass1) << 4);
+    offset0 = _mm256_add_pd(offset0, eight);
+    offset1 = _mm256_add_pd(offset1, eight);
+    if(!mask) continue;
+
+    _mm256_maskstore_pd(depths + k, _mm256_castpd_si256(pass0), z0v);
+    _mm256_maskstore_pd(depths + k + 4, _mm256_castpd_si256(pass1), z1v);
+    if(mask == 0xff)
     {
-      //right
-      right[0] = B[0] + (M[0] - B[0]) * (yCurrent - B[1]) / (M[1] - B[1]);
-      right[1] = yCurrent;
-      right[2] = B[2] + (M[2] - B[2]) * (yCurrent - B[1]) / (M[1] - B[1]);
+      __m256i * out = (__m256i *) (colors + k);
+      _mm256_storeu_si256(out, rgbA);
+      _mm256_storeu_si256(out + 1, rgbB);
+      _mm256_storeu_si256(out + 2, rgbC);
     }
-    else if(yCurrent > M[1])
+    else
     {
-      //right
-      right[0] = M[0] + (T[0] - M[0]) * (yCurrent - M[1]) / (T[1] - M[1]);
-      right[1] = yCurrent;
-      right[2] = M[2] + (T[2] - M[2]) * (yCurrent - M[1]) / (T[1] - M[1]);
+      int lane;
+      for(lane = 0; lane < 8; lane++)
+        if(mask & (1 << lane)) colors[k + lane] = c;
+    }
+  }
+#elif defined(__SSE2__)
+  __m128d zStart = _mm_set1_pd(z0);
+  __m128d zStep = _mm_set1_pd(dzdx);
+  __m128d offset = _mm_set_pd(1, 0);
+  __m128d two = _mm_set1_pd(2);
+  __m128i rgb0 = _mm_loadu_si128((__m128i *) pattern);
+  __m128i rgb1 = _mm_loadu_si128((__m128i *) pattern + 1);
+  __m128i rgb2 = _mm_loadu_si128((__m128i *) pattern + 2);
+
+  for(; k + 8 <= n; k += 8)
+  {
+    int mask = 0;
+    int pair;
+    for(pair = 0; pair < 4; pair++)
+    {
+      __m128d zv = _mm_add_pd(zStart, _mm_mul_pd(zStep, offset));
+      __m128d old = _mm_loadu_pd(depths + k + 2 * pair);
+      __m128d pass = _mm_cmple_pd(old, zv);
+      //blend instead of a masked store: passing lanes take zv
+      _mm_storeu_pd(depths + k + 2 * pair, _mm_or_pd(_mm_and_pd(pass, zv), _mm_andnot_pd(pass, old)));
+      mask |= _mm_movemask_pd(pass) << (2 * pair);
+      offset = _mm_add_pd(offset, two);
+    }
+    if(!mask) continue;
+
+    if(mask == 0xff)
+    {
+      __m128i * out = (__m128i *) (colors + k);
+      _mm_storeu_si128(out, rgb0); _mm_storeu_si128(out + 1, rgb1); _mm_storeu_si128(out + 2, rgb2);
+      _mm_storeu_si128(out + 3, rgb0); _mm_storeu_si128(out + 4, rgb1); _mm_storeu_si128(out + 5, rgb2);
     }
     else
     {
-      //right
-      right[0] = M[0];
-      right[1] = yCurrent;
-      right[2] = M[2];
+      int lane;
+      for(lane = 0; lane < 8; lane++)
+        if(mask & (1 << lane)) colors[k + lane] = c;
     }
-    draw_line((int) left[0], (int) left[1], left[2], (int) right[0], (int) right[1], right[2], s, zb, c);
-    if(debug) printf("left: (%f, %f, %f) || right: (%f, %f, %f)\n", left[0], left[1], left[2], right[0], right[1], right[2]);
-    yCurrent += step;
   }
+#endif
 
-  ///
-  free2DArray(vertices, 3);
-  free(left); free(right);
-  ///
+  for(; k < n; k++)
+  {
+    double z = z0 + dzdx * k;
+    if(depths[k] <= z)
+    {
+      depths[k] = z;
+      colors[k] = c;
+    }
+  }
 }
 
-void scanline_convert_flat(struct matrix * points, int i, screen s, zbuffer zb, double ** lightSources, int lSlength, color c_Ambient, struct constants * consts, double step)
+/*======== void masked_span() ==========
+Inputs:   color *colors
+          double *depths
+          int n
+          int x0
+          int y
+          double z0
+          double dzdx
+          color c
+Returns: 
+Like depth_span, for the n pixels of row y from x0 on, but only
+touching the ones in tiles set in draw_mask. Each pixel's depth
+is worked out from the start of the whole span, so it comes out
+exactly as depth_span would have it.
+====================*/
+static void masked_span(color * colors, double * depths, int n, int x0, int y, double z0, double dzdx, color c)
 {
-  int debug = 0;
-
-  double ** vertices = (double **) calloc(3, sizeof(double *));
+  char * tiles = draw_mask + (y / DRAW_TILE) * TILES_X;
+  int k, end;
 
-  //initialize list of points
-  int j, k;
-  for(j = 0; j < 3; j++)
+  for(k = 0; k < n; k = end)
   {
-    vertices[j] = (double *) calloc(3, sizeof(double));
-    for(k = 0; k < 3; k++)
+    end = ((x0 + k) / DRAW_TILE + 1) * DRAW_TILE - x0;
+    if(end > n) end = n;
+    if(!tiles[(x0 + k) / DRAW_TILE]) continue;
+    for(; k < end; k++)
     {
-      vertices[j][k] = points->m[k][i + j];
+      double z = z0 + dzdx * k;
+      if(depths[k] <= z)
+      {
+        depths[k] = z;
+        colors[k] = c;
+      }
     }
   }
+}
 
-  //get points in order
-  sortPointsY(vertices, 3);
-  double * B = vertices[0]; double * M = vertices[1]; double * T = vertices[2];
+/*======== void draw_span() ==========
+Inputs:   int x0
+          int x1
+          int y
+          double z0
+          double dzdx
+          screen s
+          zbuffer zb
+          color c
+Returns: 
+Draws the horizontal run of pixels from x0 to x1 (inclusive)
+on row y, starting at depth z0 and adding dzdx per pixel.
+x0 must not be greater than x1.
+The span is clipped to the screen once up front, then handed
+to depth_span to test and write across the contiguous row.
+====================*/
+void draw_span(int x0, int x1, int y, double z0, double dzdx, screen s, zbuffer zb, color c)
+{
+  int row = YRES - 1 - y;
+  if(row < 0 || row >= YRES) return;
+  if(x0 < 0)
+  {
+    z0 += dzdx * -x0;
+    x0 = 0;
+  }
+  if(x1 > XRES - 1) x1 = XRES - 1;
+  if(x0 > x1) return;
+
+  if(draw_mask)
+    masked_span(s[row] + x0, zb[row] + x0, x1 - x0 + 1, x0, y, z0, dzdx, c);
+  else
+    depth_span(s[row] + x0, zb[row] + x0, x1 - x0 + 1, z0, dzdx, c);
+}
+
+void scanline_convert_flat(struct matrix * points, int i, screen s, zbuffer zb, double ** lightSources, int lSlength, color c_Ambient, struct constants * consts, double step)
+{
+  int debug = 0;
 
   ////////////////////////////Decide Color////////////////////////////
   color c_Polygon; c_Polygon.red = 0; c_Polygon.green = 0; c_Polygon.blue = 0;
-  double * normal = calculate_normal(points, i);
+  double normal[3];
+  surface_normal(points, i, normal);
   normalize(normal);
 
   //Handle Ambient Light
@@ -155,9 +430,9 @@ void scanline_convert_flat(struct matrix * points, int i, screen s, zbuffer zb,
   c_Polygon.red += (int) c_Ambient.red * KAr; c_Polygon.green = (int) c_Ambient.green * KAg; c_Polygon.blue = (int) c_Ambient.blue * KAb;
 
   //Handle Diffuse and Specular Reflection
-  double xAvg = (B[0] + M[0] + T[0]) / 3;
-  double yAvg = (B[1] + M[1] + T[1]) / 3;
-  double zAvg = (B[2] + M[2] + T[2]) / 3;
+  double xAvg = (points->m[0][i] + points->m[0][i + 1] + points->m[0][i + 2]) / 3;
+  double yAvg = (points->m[1][i] + points->m[1][i + 1] + points->m[1][i + 2]) / 3;
+  double zAvg = (points->m[2][i] + points->m[2][i + 1] + points->m[2][i + 2]) / 3;
 
   double KDr = consts->r[1]; double KDg = consts->g[1]; double KDb = consts->b[1];
   double KSr = consts->r[2]; double KSg = consts->g[2]; double KSb = consts->b[2];
@@ -197,51 +472,9 @@ void scanline_convert_flat(struct matrix * points, int i, screen s, zbuffer zb,
   if(debug) printf("c_Polygon: (%d, %d, %d)\n", c_Polygon.red, c_Polygon.green, c_Polygon.blue);
   c_Polygon.red = setInRange(c_Polygon.red); c_Polygon.green = setInRange(c_Polygon.green); c_Polygon.blue = setInRange(c_Polygon.blue);
 
-  ////////////////////////////Draw////////////////////////////
-  double * left = (double *) calloc(3, sizeof(double)); //left will travel from B to T
-  double * right = (double *) calloc(3, sizeof(double)); //right will travel from B to M, then M to T
-
-  left[0] = right[0] = B[0]; left[1] = right[1] = B[1]; left[2] = right[2] = B[2];
-  double yCurrent = B[1];
-
-  while(yCurrent <= T[1]) //Note that B[1] is never equal to T[1], unless the triangle is degenerate.
-  {
-    //left
-    left[0] = B[0] + (T[0] - B[0]) * (yCurrent - B[1]) / (T[1] - B[1]);
-    left[1] = yCurrent;
-    left[2] = B[2] + (T[2] - B[2]) * (yCurrent - B[1]) / (T[1] - B[1]);
 
-    if(yCurrent < M[1]) //M[1] > B[1]
-    {
-      //right
-      right[0] = B[0] + (M[0] - B[0]) * (yCurrent - B[1]) / (M[1] - B[1]);
-      right[1] = yCurrent;
-      right[2] = B[2] + (M[2] - B[2]) * (yCurrent - B[1]) / (M[1] - B[1]);
-    }
-    else if(yCurrent > M[1])
-    {
-      //right
-      right[0] = M[0] + (T[0] - M[0]) * (yCurrent - M[1]) / (T[1] - M[1]);
-      right[1] = yCurrent;
-      right[2] = M[2] + (T[2] - M[2]) * (yCurrent - M[1]) / (T[1] - M[1]);
-    }
-    else
-    {
-      //right
-      right[0] = M[0];
-      right[1] = yCurrent;
-      right[2] = M[2];
-    }
-    draw_line((int) left[0], (int) left[1], left[2], (int) right[0], (int) right[1], right[2], s, zb, c_Polygon);
-    //printf("left: (%f, %f, %f) || right: (%f, %f, %f)\n", left[0], left[1], left[2], right[0], right[1], right[2]);
-    yCurrent += step;
-  }
-
-  ///
-  free2DArray(vertices, 3);
-  free(left); free(right);
-  free(normal);
-  ///  
+  ////////////////////////////Draw////////////////////////////
+  scanline_convert(points, i, s, zb, c_Polygon, step);
 }
 
 /*======== void add_polygon() ==========
@@ -283,11 +516,15 @@ void draw_polygons( struct matrix *polygons, screen s, zbuffer zb, color c, doub
   }
  
   int point;
-  double *normal;
+  double normal[3];
   
   for (point=0; point < polygons->lastcol-2; point+=3) {
 
-    normal = calculate_normal(polygons, point);
+    //points behind the camera come back from matrix_mult_project with w = 0
+    if ( !polygons->m[3][point] || !polygons->m[3][point+1] || !polygons->m[3][point+2] )
+      continue;
+
+    surface_normal(polygons, point, normal);
     
     if ( normal[2] > 0 ) {
       
@@ -306,11 +543,14 @@ void draw_polygons_flat(struct matrix * polygons, screen s, zbuffer zb, double *
   }
 
   int point;
-  double * normal;
+  double normal[3];
 
   for(point = 0; point < polygons->lastcol - 2; point += 3) {
 
-    normal = calculate_normal(polygons, point);
+    //points behind the camera come back from matrix_mult_project with w = 0
+    if(!polygons->m[3][point] || !polygons->m[3][point + 1] || !polygons->m[3][point + 2]) continue;
+
+    surface_normal(polygons, point, normal);
 
     if(normal[2] > 0)
     {
@@ -318,7 +558,6 @@ void draw_polygons_flat(struct matrix * polygons, screen s, zbuffer zb, double *
     }
 
   }
-  free(normal);
 }
 
 /*======== void add_box() ==========
@@ -365,6 +604,36 @@ void add_box( struct matrix * polygons, double x, double y, double z, double wid
   add_polygon(polygons, x, y1, z, x, y1, z1, x1, y1, z1);
 }//end add_box
 
+/*======== void add_mesh() ==========
+  Inputs:   struct matrix * polygons
+            struct mesh * m
+            int first
+            int count
+  Returns: 
+
+  adds count triangles of the mesh m, starting at triangle
+  first, to the polygon matrix. Large meshes are drawn a batch
+  at a time this way so the polygon matrix stays small.
+  The polygon matrix is grown once to fit the whole batch
+  instead of 100 points at a time.
+  ====================*/
+void add_mesh( struct matrix * polygons, struct mesh * m, int first, int count ) {
+
+  int t, k;
+  const float *v;
+
+  if ( first + count > m->num_triangles )
+    count = m->num_triangles - first;
+  if ( polygons->lastcol + 3 * count > polygons->cols )
+    grow_matrix( polygons, polygons->lastcol + 3 * count );
+
+  for ( t = first; t < first + count; t++ )
+    for ( k = 0; k < 3; k++ ) {
+      v = m->vertices + 3 * m->triangles[3 * t + k];
+      add_point( polygons, v[0], v[1], v[2] );
+    }
+}
+
 /*======== void add_sphere() ==========
   Inputs:   struct matrix * points
             double cx
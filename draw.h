@@ -4,6 +4,7 @@
 #include "matrix.h"
 #include "ml6.h"
 #include "symtab.h"
+#include "mesh.h"
 
 void free2DArray(double ** a, int len);
 void scanline_convert( struct matrix *points, int i, screen s, zbuffer zb, color c, double step);
@@ -32,6 +33,7 @@ void add_torus( struct matrix * edges,
 		double r1, double r2, double step );
 struct matrix * generate_torus( double cx, double cy, double cz,
 				double r1, double r2, double step );
+void add_mesh( struct matrix * polygons, struct mesh * m, int first, int count );
 
 //advanced shapes
 void add_circle( struct matrix * edges, 
@@ -50,5 +52,6 @@ void add_edge( struct matrix * points,
 	       double x1, double y1, double z1);
 void draw_lines( struct matrix * points, screen s, zbuffer zb, color c);
 void draw_line(int x0, int y0, double z0, int x1, int y1, double z1, screen s, zbuffer zb, color c);
+void draw_span(int x0, int x1, int y, double z0, double dzdx, screen s, zbuffer zb, color c);
 
 #endif
@@ -7,9 +7,24 @@
 
 double *calculate_normal(struct matrix *polygons, int i) {
 
+  double *N = (double *)malloc(3 * sizeof(double));
+  surface_normal(polygons, i, N);
+  return N;
+}
+
+/*======== void surface_normal() ==========
+  Inputs:   struct matrix *polygons
+            int i
+            double *N
+  Returns: 
+
+  Stores the (unnormalized) normal of the triangle made of
+  points i, i+1 and i+2 in N, without allocating
+  ====================*/
+void surface_normal(struct matrix *polygons, int i, double *N) {
+
   double A[3];
   double B[3];
-  double *N = (double *)malloc(3 * sizeof(double));
 
   A[0] = polygons->m[0][i+1] - polygons->m[0][i];
   A[1] = polygons->m[1][i+1] - polygons->m[1][i];
@@ -22,8 +37,6 @@ double *calculate_normal(struct matrix *polygons, int i) {
   N[0] = A[1] * B[2] - A[2] * B[1];
   N[1] = A[2] * B[0] - A[0] * B[2];
   N[2] = A[0] * B[1] - A[1] * B[0];
-    
-  return N;
 }
 
 void normalize(double * vector)
@@ -4,6 +4,7 @@
 #include "matrix.h"
 
 double *calculate_normal(struct matrix *polygons, int i);
+void surface_normal(struct matrix *polygons, int i, double *N);
 void normalize(double * vector);
 
 #endif
@@ -3,6 +3,7 @@
 #include <math.h>
 
 #include "matrix.h"
+#include "ml6.h"
 
 /*======== struct matrix * make_bezier() ==========
   Inputs:   
@@ -200,6 +201,74 @@ struct matrix * make_rotZ(double theta) {
 }
 
 
+/*======== struct matrix * make_perspective() ==========
+Inputs:  double *eye
+         double *aim
+         double focal
+Returns: The view-projection matrix for a camera at eye looking
+at aim, with focal as the distance to the image plane.
+
+The camera's up direction is +y. After multiplying by this
+matrix and dividing by w (see matrix_mult_project), x and y are
+screen coordinates, with the aim point at the center of the
+screen, and z is focal^2 / d - focal for a point at distance d
+from the eye. That depth grows toward the viewer like the
+orthographic one, matches it in scale at the image plane, and
+interpolates linearly across the screen.
+====================*/
+struct matrix * make_perspective(double *eye, double *aim, double focal) {
+  struct matrix *t = new_matrix(4, 4);
+  double f[3], r[3], u[3], up[3] = {0, 1, 0};
+  double mag;
+  int i;
+
+  for (i=0; i < 3; i++)
+    f[i] = aim[i] - eye[i];
+  mag = sqrt(f[0]*f[0] + f[1]*f[1] + f[2]*f[2]);
+  for (i=0; i < 3; i++)
+    f[i] /= mag;
+  if ( fabs(f[1]) > 0.999 ) { //looking straight up or down
+    up[1] = 0;
+    up[2] = 1;
+  }
+
+  //right = f x up, u = right x f
+  r[0] = f[1]*up[2] - f[2]*up[1];
+  r[1] = f[2]*up[0] - f[0]*up[2];
+  r[2] = f[0]*up[1] - f[1]*up[0];
+  mag = sqrt(r[0]*r[0] + r[1]*r[1] + r[2]*r[2]);
+  for (i=0; i < 3; i++)
+    r[i] /= mag;
+  u[0] = r[1]*f[2] - r[2]*f[1];
+  u[1] = r[2]*f[0] - r[0]*f[2];
+  u[2] = r[0]*f[1] - r[1]*f[0];
+
+  //view: rows are the camera axes, the camera looks down -z
+  double view[4][4] = {
+    { r[0], r[1], r[2], -(r[0]*eye[0] + r[1]*eye[1] + r[2]*eye[2]) },
+    { u[0], u[1], u[2], -(u[0]*eye[0] + u[1]*eye[1] + u[2]*eye[2]) },
+    { -f[0], -f[1], -f[2], f[0]*eye[0] + f[1]*eye[1] + f[2]*eye[2] },
+    { 0, 0, 0, 1 }
+  };
+  //projection: w is the distance in front of the eye
+  double proj[4][4] = {
+    { focal, 0, -XRES / 2.0, 0 },
+    { 0, focal, -YRES / 2.0, 0 },
+    { 0, 0, focal, focal * focal },
+    { 0, 0, -1, 0 }
+  };
+
+  int r0, c0, k;
+  for (r0=0; r0 < 4; r0++)
+    for (c0=0; c0 < 4; c0++) {
+      t->m[r0][c0] = 0;
+      for (k=0; k < 4; k++)
+	t->m[r0][c0] += proj[r0][k] * view[k][c0];
+    }
+  t->lastcol = 4;
+  return t;
+}
+
 /*-------------- void print_matrix() --------------
 Inputs:  struct matrix *m 
 Returns: 
@@ -278,6 +347,39 @@ void matrix_mult(struct matrix *a, struct matrix *b) {
 }//end matrix_mult
 
 
+/*-------------- void matrix_mult_project() --------------
+Inputs:  struct matrix *a
+         struct matrix *b 
+Returns: 
+
+a*b -> b, then divides each point by its w in the same pass.
+Points that end up closer than NEAR_PLANE to the eye (or behind
+it) can't be projected; their w is set to 0 so the polygons
+using them are culled. Every other point gets w = 1.
+*/
+void matrix_mult_project(struct matrix *a, struct matrix *b) {
+  int c;
+  double x, y, z, w;
+
+  for (c=0; c < b->lastcol; c++) {
+    x = b->m[0][c];
+    y = b->m[1][c];
+    z = b->m[2][c];
+    w = b->m[3][c];
+
+    double tw = a->m[3][0] * x + a->m[3][1] * y + a->m[3][2] * z + a->m[3][3] * w;
+    if ( tw < NEAR_PLANE ) {
+      b->m[3][c] = 0;
+      continue;
+    }
+    b->m[0][c] = (a->m[0][0] * x + a->m[0][1] * y + a->m[0][2] * z + a->m[0][3] * w) / tw;
+    b->m[1][c] = (a->m[1][0] * x + a->m[1][1] * y + a->m[1][2] * z + a->m[1][3] * w) / tw;
+    b->m[2][c] = (a->m[2][0] * x + a->m[2][1] * y + a->m[2][2] * z + a->m[2][3] * w) / tw;
+    b->m[3][c] = 1;
+  }
+}//end matrix_mult_project
+
+
 /*===============================================
   These Functions do not need to be modified
   ===============================================*/
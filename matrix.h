@@ -4,6 +4,9 @@
 #define HERMITE 0
 #define BEZIER 1
 
+//points closer to the camera than this are culled
+#define NEAR_PLANE 1
+
 struct matrix {
   double **m;
   int rows, cols;
@@ -22,6 +25,7 @@ struct matrix * make_scale(double x, double y, double z);
 struct matrix * make_rotX(double theta);
 struct matrix * make_rotY(double theta);
 struct matrix * make_rotZ(double theta);
+struct matrix * make_perspective(double *eye, double *aim, double focal);
 
 //Basic matrix manipulation routines
 struct matrix *new_matrix(int rows, int cols);
@@ -32,5 +36,6 @@ void print_matrix(struct matrix *m);
 void ident(struct matrix *m);
 void scalar_mult(double x, struct matrix *m);
 void matrix_mult(struct matrix *a, struct matrix *b);
+void matrix_mult_project(struct matrix *a, struct matrix *b);
 
 #endif
@@ -3,18 +3,24 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 #include "parser.h"
 #include "matrix.h"
 
   SYMTAB *s;
   struct light *l;
   struct constants *c;
-  struct command op[MAX_COMMANDS];
-  struct matrix *m;
+  struct command *op = NULL;
   int lastop=0;
+  int max_ops=0;
   int lineno=0;
+  struct options options;
 #define YYERROR_VERBOSE 1
 
+  int yylex();
+  int yyerror(char *s);
+  void next_op();
+
   %}
 
 
@@ -63,7 +69,7 @@ LIGHT STRING DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE
   op[lastop].op.light.c[2] = $8;
   op[lastop].op.light.c[3] = 0;
   op[lastop].op.light.p = add_symbol($2,SYM_LIGHT,l);
-  lastop++;
+  next_op();
 }|
 
 MOVE DOUBLE DOUBLE DOUBLE STRING
@@ -75,7 +81,8 @@ MOVE DOUBLE DOUBLE DOUBLE STRING
   op[lastop].op.move.d[2] = $4;
   op[lastop].op.move.d[3] = 0;
   op[lastop].op.move.p = add_symbol($5,SYM_VALUE,0);
-  lastop++;
+  op[lastop].op.move.knob = knob_slot(op[lastop].op.move.p);
+  next_op();
 }
 |
 MOVE DOUBLE DOUBLE DOUBLE
@@ -87,7 +94,8 @@ MOVE DOUBLE DOUBLE DOUBLE
   op[lastop].op.move.d[2] = $4;
   op[lastop].op.move.d[3] = 0;
   op[lastop].op.move.p = NULL;
-  lastop++;
+  op[lastop].op.move.knob = -1;
+  next_op();
 }|
 
 CONSTANTS STRING DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE
@@ -115,7 +123,7 @@ CONSTANTS STRING DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE
 
   op[lastop].op.constants.p =  add_symbol($2,SYM_CONSTANTS,c);
   op[lastop].opcode=CONSTANTS;
-  lastop++;
+  next_op();
 }|
 
 CONSTANTS STRING DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE
@@ -142,16 +150,15 @@ CONSTANTS STRING DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE
   c->blue = $14;
   op[lastop].op.constants.p =  add_symbol($2,SYM_CONSTANTS,c);
   op[lastop].opcode=CONSTANTS;
-  lastop++;
+  next_op();
 }|
 
 SAVE_COORDS STRING
 {
   lineno++;
   op[lastop].opcode = SAVE_COORDS;
-  m = new_matrix(4,4);
-  op[lastop].op.save_coordinate_system.p = add_symbol($2,SYM_MATRIX,m);
-  lastop++;
+  op[lastop].op.save_coordinate_system.p = add_symbol($2,SYM_MATRIX,0);
+  next_op();
 }|
 
 CAMERA DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE
@@ -166,7 +173,7 @@ CAMERA DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE
   op[lastop].op.camera.aim[1] = $6;
   op[lastop].op.camera.aim[2] = $7;
   op[lastop].op.camera.aim[3] = 0;
-  lastop++;
+  next_op();
 }|
 TEXTURE STRING DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE
 {
@@ -188,7 +195,7 @@ TEXTURE STRING DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DO
   op[lastop].op.texture.cs = NULL;
   op[lastop].op.texture.constants =  add_symbol("",SYM_CONSTANTS,c);
   op[lastop].op.texture.p = add_symbol($2,SYM_FILE,0);
-  lastop++;
+  next_op();
 }|
 SPHERE DOUBLE DOUBLE DOUBLE DOUBLE
 {
@@ -201,7 +208,7 @@ SPHERE DOUBLE DOUBLE DOUBLE DOUBLE
   op[lastop].op.sphere.r = $5;
   op[lastop].op.sphere.constants = NULL;
   op[lastop].op.sphere.cs = NULL;
-  lastop++;
+  next_op();
 }|
 SPHERE DOUBLE DOUBLE DOUBLE DOUBLE STRING
 {
@@ -213,9 +220,8 @@ SPHERE DOUBLE DOUBLE DOUBLE DOUBLE STRING
   op[lastop].op.sphere.d[3] = 0;
   op[lastop].op.sphere.r = $5;
   op[lastop].op.sphere.constants = NULL;
-  m = (struct matrix *)new_matrix(4,4);
-  op[lastop].op.sphere.cs = add_symbol($6,SYM_MATRIX,m);
-  lastop++;
+  op[lastop].op.sphere.cs = add_symbol($6,SYM_MATRIX,0);
+  next_op();
 }|
 SPHERE STRING DOUBLE DOUBLE DOUBLE DOUBLE 
 {
@@ -229,7 +235,7 @@ SPHERE STRING DOUBLE DOUBLE DOUBLE DOUBLE
   op[lastop].op.sphere.cs = NULL;
   c = (struct constants *)malloc(sizeof(struct constants));
   op[lastop].op.sphere.constants = add_symbol($2,SYM_CONSTANTS,c);
-  lastop++;
+  next_op();
 }|
 SPHERE STRING DOUBLE DOUBLE DOUBLE DOUBLE STRING
 {
@@ -241,11 +247,10 @@ SPHERE STRING DOUBLE DOUBLE DOUBLE DOUBLE STRING
   op[lastop].op.sphere.d[3] = 0;
   op[lastop].op.sphere.r = $6;
   op[lastop].op.sphere.constants = NULL;
-  m = (struct matrix *)new_matrix(4,4);
-  op[lastop].op.sphere.cs = add_symbol($7,SYM_MATRIX,m);
+  op[lastop].op.sphere.cs = add_symbol($7,SYM_MATRIX,0);
   c = (struct constants *)malloc(sizeof(struct constants));
   op[lastop].op.sphere.constants = add_symbol($2,SYM_CONSTANTS,c);
-  lastop++;
+  next_op();
 }| 
 
 TORUS DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE
@@ -261,7 +266,7 @@ TORUS DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE
   op[lastop].op.torus.constants = NULL;
   op[lastop].op.torus.cs = NULL;
 
-  lastop++;
+  next_op();
 }|
 TORUS DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE STRING
 {
@@ -274,9 +279,8 @@ TORUS DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE STRING
   op[lastop].op.torus.r0 = $5;
   op[lastop].op.torus.r1 = $6;
   op[lastop].op.torus.constants = NULL;
-  m = (struct matrix *)new_matrix(4,4);
-  op[lastop].op.torus.cs = add_symbol($7,SYM_MATRIX,m);
-  lastop++;
+  op[lastop].op.torus.cs = add_symbol($7,SYM_MATRIX,0);
+  next_op();
 }|
 TORUS STRING DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE
 {
@@ -292,7 +296,7 @@ TORUS STRING DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE
   c = (struct constants *)malloc(sizeof(struct constants));
   op[lastop].op.torus.constants = add_symbol($2,SYM_CONSTANTS,c);
 
-  lastop++;
+  next_op();
 }|
 TORUS STRING DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE STRING
 {
@@ -306,10 +310,9 @@ TORUS STRING DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE STRING
   op[lastop].op.torus.r1 = $7;
   c = (struct constants *)malloc(sizeof(struct constants));
   op[lastop].op.torus.constants = add_symbol($2,SYM_CONSTANTS,c);
-  m = (struct matrix *)new_matrix(4,4);
-  op[lastop].op.torus.cs = add_symbol($8,SYM_MATRIX,m);
+  op[lastop].op.torus.cs = add_symbol($8,SYM_MATRIX,0);
 
-  lastop++;
+  next_op();
 }| 
 BOX DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE
 {
@@ -326,7 +329,7 @@ BOX DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE
 
   op[lastop].op.box.constants = NULL;
   op[lastop].op.box.cs = NULL;
-  lastop++;
+  next_op();
 }|
 BOX DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE STRING
 {
@@ -342,9 +345,8 @@ BOX DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE STRING
   op[lastop].op.box.d1[3] = 0;
 
   op[lastop].op.box.constants = NULL;
-  m = (struct matrix *)new_matrix(4,4);
-  op[lastop].op.box.cs = add_symbol($8,SYM_MATRIX,m);
-  lastop++;
+  op[lastop].op.box.cs = add_symbol($8,SYM_MATRIX,0);
+  next_op();
 }|
 BOX STRING DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE
 {
@@ -361,7 +363,7 @@ BOX STRING DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE
   c = (struct constants *)malloc(sizeof(struct constants));
   op[lastop].op.box.constants = add_symbol($2,SYM_CONSTANTS,c);
   op[lastop].op.box.cs = NULL;
-  lastop++;
+  next_op();
 }|
 BOX STRING DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE STRING
 {
@@ -377,10 +379,9 @@ BOX STRING DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE STRING
   op[lastop].op.box.d1[3] = 0;
   c = (struct constants *)malloc(sizeof(struct constants));
   op[lastop].op.box.constants = add_symbol($2,SYM_CONSTANTS,c);
-  m = (struct matrix *)new_matrix(4,4);
-  op[lastop].op.box.cs = add_symbol($9,SYM_MATRIX,m);
+  op[lastop].op.box.cs = add_symbol($9,SYM_MATRIX,0);
 
-  lastop++;
+  next_op();
 }|
 
 
@@ -399,7 +400,7 @@ LINE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE
   op[lastop].op.line.constants = NULL;
   op[lastop].op.line.cs0 = NULL;
   op[lastop].op.line.cs1 = NULL;
-  lastop++;
+  next_op();
 }|
 /* first do cs0, then cs1, then both - BUT NO CONSTANTS */
 LINE DOUBLE DOUBLE DOUBLE STRING DOUBLE DOUBLE DOUBLE
@@ -415,10 +416,9 @@ LINE DOUBLE DOUBLE DOUBLE STRING DOUBLE DOUBLE DOUBLE
   op[lastop].op.line.p1[2] = $8;
   op[lastop].op.line.p1[3] = 0;
   op[lastop].op.line.constants = NULL;
-  m = (struct matrix *)new_matrix(4,4);
-  op[lastop].op.line.cs0 = add_symbol($5,SYM_MATRIX,m);
+  op[lastop].op.line.cs0 = add_symbol($5,SYM_MATRIX,0);
   op[lastop].op.line.cs1 = NULL;
-  lastop++;
+  next_op();
 }|
 LINE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE STRING
 {
@@ -434,9 +434,8 @@ LINE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE STRING
   op[lastop].op.line.p1[3] = 0;
   op[lastop].op.line.constants = NULL;
   op[lastop].op.line.cs0 = NULL;
-  m = (struct matrix *)new_matrix(4,4);
-  op[lastop].op.line.cs1 = add_symbol($8,SYM_MATRIX,m);
-  lastop++;
+  op[lastop].op.line.cs1 = add_symbol($8,SYM_MATRIX,0);
+  next_op();
 }|
 LINE DOUBLE DOUBLE DOUBLE STRING DOUBLE DOUBLE DOUBLE STRING
 {
@@ -451,11 +450,9 @@ LINE DOUBLE DOUBLE DOUBLE STRING DOUBLE DOUBLE DOUBLE STRING
   op[lastop].op.line.p1[2] = $8;
   op[lastop].op.line.p1[3] = 0;
   op[lastop].op.line.constants = NULL;
-  m = (struct matrix *)new_matrix(4,4);
-  op[lastop].op.line.cs0 = add_symbol($5,SYM_MATRIX,m);
-  m = (struct matrix *)new_matrix(4,4);
-  op[lastop].op.line.cs1 = add_symbol($9,SYM_MATRIX,m);
-  lastop++;
+  op[lastop].op.line.cs0 = add_symbol($5,SYM_MATRIX,0);
+  op[lastop].op.line.cs1 = add_symbol($9,SYM_MATRIX,0);
+  next_op();
 }|
 /* now do constants, and constants with the cs stuff */
 LINE STRING DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE
@@ -474,7 +471,7 @@ LINE STRING DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE
   op[lastop].op.line.constants = add_symbol($2,SYM_CONSTANTS,c);
   op[lastop].op.line.cs0 = NULL;
   op[lastop].op.line.cs1 = NULL;
-  lastop++;
+  next_op();
 }|
 LINE STRING DOUBLE DOUBLE DOUBLE STRING DOUBLE DOUBLE DOUBLE
 {
@@ -490,10 +487,9 @@ LINE STRING DOUBLE DOUBLE DOUBLE STRING DOUBLE DOUBLE DOUBLE
   op[lastop].op.line.p1[3] = 0;
   c = (struct constants *)malloc(sizeof(struct constants));
   op[lastop].op.line.constants = add_symbol($2,SYM_CONSTANTS,c);
-  m = (struct matrix *)new_matrix(4,4);
-  op[lastop].op.line.cs0 = add_symbol($6,SYM_MATRIX,m);
+  op[lastop].op.line.cs0 = add_symbol($6,SYM_MATRIX,0);
   op[lastop].op.line.cs1 = NULL;
-  lastop++;
+  next_op();
 }|
 LINE STRING DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE STRING
 {
@@ -510,10 +506,9 @@ LINE STRING DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE STRING
   c = (struct constants *)malloc(sizeof(struct constants));
   op[lastop].op.line.constants = add_symbol($2,SYM_CONSTANTS,c);
   op[lastop].op.line.cs0 = NULL;
-  m = (struct matrix *)new_matrix(4,4);
-  op[lastop].op.line.cs1 = add_symbol($9,SYM_MATRIX,m);
+  op[lastop].op.line.cs1 = add_symbol($9,SYM_MATRIX,0);
   op[lastop].op.line.cs0 = NULL;
-  lastop++;
+  next_op();
 }|
 LINE STRING DOUBLE DOUBLE DOUBLE STRING DOUBLE DOUBLE DOUBLE STRING
 {
@@ -529,11 +524,9 @@ LINE STRING DOUBLE DOUBLE DOUBLE STRING DOUBLE DOUBLE DOUBLE STRING
   op[lastop].op.line.p1[3] = 0;
   c = (struct constants *)malloc(sizeof(struct constants));
   op[lastop].op.line.constants = add_symbol($2,SYM_CONSTANTS,c);
-  m = (struct matrix *)new_matrix(4,4);
-  op[lastop].op.line.cs0 = add_symbol($6,SYM_MATRIX,m);
-  m = (struct matrix *)new_matrix(4,4);
-  op[lastop].op.line.cs1 = add_symbol($10,SYM_MATRIX,m);
-  lastop++;
+  op[lastop].op.line.cs0 = add_symbol($6,SYM_MATRIX,0);
+  op[lastop].op.line.cs1 = add_symbol($10,SYM_MATRIX,0);
+  next_op();
 }|
 MESH CO STRING
 {
@@ -542,7 +535,7 @@ MESH CO STRING
   strcpy(op[lastop].op.mesh.name,$3);
   op[lastop].op.mesh.constants = NULL;
   op[lastop].op.mesh.cs = NULL;
-  lastop++;
+  next_op();
 }|
 MESH STRING CO STRING
 { /* name and constants */
@@ -552,7 +545,7 @@ MESH STRING CO STRING
   c = (struct constants *)malloc(sizeof(struct constants));
   op[lastop].op.mesh.constants = add_symbol($2,SYM_CONSTANTS,c);
   op[lastop].op.mesh.cs = NULL;
-  lastop++;
+  next_op();
 } |
 MESH STRING CO STRING STRING
 {
@@ -561,18 +554,18 @@ MESH STRING CO STRING STRING
   strcpy(op[lastop].op.mesh.name,$4);
   c = (struct constants *)malloc(sizeof(struct constants));
   op[lastop].op.mesh.constants = add_symbol($2,SYM_CONSTANTS,c);
-  m = (struct matrix *)new_matrix(4,4);
-  op[lastop].op.mesh.cs = add_symbol($5,SYM_MATRIX,m);
-  lastop++;
+  op[lastop].op.mesh.cs = add_symbol($5,SYM_MATRIX,0);
+  next_op();
 } |
 SET STRING DOUBLE
 {
   lineno++;
   op[lastop].opcode = SET;
   op[lastop].op.set.p = add_symbol($2,SYM_VALUE,0);
-  set_value(op[lastop].op.set.p,$3);
+  op[lastop].op.set.knob = knob_slot(op[lastop].op.set.p);
+  set_knob(op[lastop].op.set.knob,$3);
   op[lastop].op.set.val = $3;
-  lastop++;
+  next_op();
 }|
 SCALE DOUBLE DOUBLE DOUBLE STRING
 {
@@ -583,7 +576,8 @@ SCALE DOUBLE DOUBLE DOUBLE STRING
   op[lastop].op.scale.d[2] = $4;
   op[lastop].op.scale.d[3] = 0;
   op[lastop].op.scale.p = add_symbol($5,SYM_VALUE,0);
-  lastop++;
+  op[lastop].op.scale.knob = knob_slot(op[lastop].op.scale.p);
+  next_op();
 }|
 SCALE DOUBLE DOUBLE DOUBLE
 {
@@ -594,7 +588,8 @@ SCALE DOUBLE DOUBLE DOUBLE
   op[lastop].op.scale.d[2] = $4;
   op[lastop].op.scale.d[3] = 0;
   op[lastop].op.scale.p = NULL;
-  lastop++;
+  op[lastop].op.scale.knob = -1;
+  next_op();
 }|
 ROTATE STRING DOUBLE STRING
 {
@@ -618,8 +613,9 @@ ROTATE STRING DOUBLE STRING
 
   op[lastop].op.rotate.degrees = $3;
   op[lastop].op.rotate.p = add_symbol($4,SYM_VALUE,0);
+  op[lastop].op.rotate.knob = knob_slot(op[lastop].op.rotate.p);
   
-  lastop++;
+  next_op();
 }|
 ROTATE STRING DOUBLE
 {
@@ -642,21 +638,22 @@ ROTATE STRING DOUBLE
     }
   op[lastop].op.rotate.degrees = $3;
   op[lastop].op.rotate.p = NULL;
-  lastop++;
+  op[lastop].op.rotate.knob = -1;
+  next_op();
 }|
 BASENAME STRING
 {
   lineno++;
   op[lastop].opcode = BASENAME;
   op[lastop].op.basename.p = add_symbol($2,SYM_STRING,0);
-  lastop++;
+  next_op();
 }|
 SAVE_KNOBS STRING
 {
   lineno++;
   op[lastop].opcode = SAVE_KNOBS;
-  op[lastop].op.save_knobs.p = add_symbol($2,SYM_STRING,0);
-  lastop++;
+  op[lastop].op.save_knobs.p = add_symbol($2,SYM_KNOBLIST,0);
+  next_op();
 }|
 TWEEN DOUBLE DOUBLE STRING STRING
 {
@@ -664,85 +661,86 @@ TWEEN DOUBLE DOUBLE STRING STRING
   op[lastop].opcode = TWEEN;
   op[lastop].op.tween.start_frame = $2;
   op[lastop].op.tween.end_frame = $3;
-  op[lastop].op.tween.knob_list0 = add_symbol($4,SYM_STRING,0);
-  op[lastop].op.tween.knob_list1 = add_symbol($5,SYM_STRING,0);
-  lastop++;
+  op[lastop].op.tween.knob_list0 = add_symbol($4,SYM_KNOBLIST,0);
+  op[lastop].op.tween.knob_list1 = add_symbol($5,SYM_KNOBLIST,0);
+  next_op();
 }|
 FRAMES DOUBLE
 {
   lineno++;
   op[lastop].opcode = FRAMES;
   op[lastop].op.frames.num_frames = $2;
-  lastop++;
+  next_op();
 }|
 VARY STRING DOUBLE DOUBLE DOUBLE DOUBLE
 {
   lineno++;
   op[lastop].opcode = VARY;
-  op[lastop].op.vary.p = add_symbol($2,SYM_STRING,0);
+  op[lastop].op.vary.p = add_symbol($2,SYM_VALUE,0);
+  op[lastop].op.vary.knob = knob_slot(op[lastop].op.vary.p);
   op[lastop].op.vary.start_frame = $3;
   op[lastop].op.vary.end_frame = $4;
   op[lastop].op.vary.start_val = $5;
   op[lastop].op.vary.end_val = $6;
-  lastop++;
+  next_op();
 }|
 PUSH
 {
   lineno++;
   op[lastop].opcode = PUSH;
-  lastop++;
+  next_op();
 }|
 GENERATE_RAYFILES
 {
   lineno++;
   op[lastop].opcode = GENERATE_RAYFILES;
-  lastop++;
+  next_op();
 }|
 POP
 {
   lineno++;
   op[lastop].opcode = POP;
-  lastop++;
+  next_op();
 }|
 SAVE STRING
 {
   lineno++;
   op[lastop].opcode = SAVE;
   op[lastop].op.save.p = add_symbol($2,SYM_FILE,0);
-  lastop++;
+  next_op();
 }|
 SHADING SHADING_TYPE
 {
   lineno++;
   op[lastop].opcode = SHADING;
   op[lastop].op.shading.p = add_symbol($2,SYM_STRING,0);
-  lastop++;
+  next_op();
 }|
 SETKNOBS DOUBLE
 {
   lineno++;
   op[lastop].opcode = SETKNOBS;
   op[lastop].op.setknobs.value = $2;
-  lastop++;
+  next_op();
 }|
 FOCAL DOUBLE
 {
   lineno++;
   op[lastop].opcode = FOCAL;
   op[lastop].op.focal.value = $2;
-  lastop++;
+  next_op();
 }|
 DISPLAY
 {
   lineno++;
   op[lastop].opcode = DISPLAY;
-  lastop++;
+  next_op();
 }|
 WEB
 {
   lineno++;
   op[lastop].opcode = WEB;
-  lastop++;
+  next_op();
 }|
 AMBIENT DOUBLE DOUBLE DOUBLE
 {
@@ -751,7 +749,7 @@ AMBIENT DOUBLE DOUBLE DOUBLE
   op[lastop].op.ambient.c[0] = $2;
   op[lastop].op.ambient.c[1] = $3;
   op[lastop].op.ambient.c[2] = $4;
-  lastop++;
+  next_op();
 };
 
 
@@ -775,20 +773,164 @@ int yywrap()
   return 1;
 }
 
+/*======== void grow_ops() ==========
+Inputs:
+Returns:
+
+Doubles the room in op. The new commands are zeroed, like
+the fixed size array op used to be.
+====================*/
+static void grow_ops()
+{
+  int old = max_ops;
+
+  max_ops = max_ops ? max_ops * 2 : 512;
+  op = (struct command *)realloc(op, max_ops * sizeof(struct command));
+  memset(op + old, 0, (max_ops - old) * sizeof(struct command));
+}
+
+/*======== void next_op() ==========
+Inputs:
+Returns:
+
+Moves on to the next command, making sure op[lastop] exists
+====================*/
+void next_op()
+{
+  lastop++;
+  if (lastop == max_ops)
+    grow_ops();
+}
+
 
 extern FILE *yyin;
 
 
+#define USAGE "usage: %s [-r raw_file] [-y video_file] [-s shm_name] [-p]\n" \
+  "           [-i | -u socket | -b batch_file]\n"			\
+  "           [-f first-last | -n shard/n | -m] [-c] script.mdl\n"
+
+/*======== int main() ==========
+  usage: mdl [options] script.mdl
+
+  -r raw_file    write every frame to the raw frame file
+                 raw_file (see output.h) instead of images
+  -y video_file  stream every frame as YUV4MPEG2 to
+                 video_file, which may be a FIFO, or - for
+                 stdout, instead of saving images. Anything
+                 else printed then goes to stderr.
+  -s shm_name    publish display commands and every finished
+                 frame to the shared memory object shm_name
+                 (see display.h) instead of running display
+  -p             draw a still image progressively, publishing
+                 coarse previews to the shared memory display
+                 before the full quality one. When serving,
+                 renders are drawn this way in the background
+                 (see server.c).
+  -i             serve the scene: keep it loaded and draw it
+                 on commands read from stdin (see server.c),
+                 replying on stdout. Anything else printed
+                 then goes to stderr.
+  -u socket      serve the scene to clients of the UNIX
+                 domain socket at socket
+  -b batch_file  draw an image for each knob setting listed
+                 in batch_file (see server.c), using every cpu
+  -f first-last  draw only frames first to last of an animation
+  -n shard/n     split the frames into n shards and draw only
+                 shard number shard (0 to n-1), so n runs, on
+                 any machines, draw every frame exactly once
+  -m             draw nothing, just make the animation from the
+                 frames saved by earlier -f or -n runs
+  -c             keep a journal of the frames saved, and skip
+                 the ones an earlier run of the same script
+                 already saved, to resume after a crash
+  ====================*/
 int main(int argc, char **argv) {
 
-  yyin = fopen(argv[1],"r");
+  int c, n;
 
+  options.y4m_fd = -1;
+  options.first_frame = -1;
+  options.last_frame = -1;
+  while ( (c = getopt(argc, argv, "r:y:s:piu:b:f:n:mc")) != -1 ) {
+    switch (c) {
+    case 'r':
+      options.raw_file = optarg;
+      break;
+    case 'y':
+      options.y4m_file = optarg;
+      break;
+    case 's':
+      options.shm_name = optarg;
+      break;
+    case 'p':
+      options.preview = 1;
+      break;
+    case 'i':
+      options.serve = 1;
+      break;
+    case 'u':
+      options.serve = 1;
+      options.socket_path = optarg;
+      break;
+    case 'b':
+      options.batch_file = optarg;
+      break;
+    case 'f':
+      n = sscanf(optarg, "%d-%d", &options.first_frame, &options.last_frame);
+      if ( n == 1 )
+	options.last_frame = options.first_frame;
+      if ( n < 1 || options.first_frame < 0 || options.last_frame < options.first_frame ) {
+	printf("Error: bad frame range %s\n", optarg);
+	return 1;
+      }
+      break;
+    case 'n':
+      if ( sscanf(optarg, "%d/%d", &options.shard, &options.num_shards) != 2 ||
+	   options.shard < 0 || options.shard >= options.num_shards ) {
+	printf("Error: bad shard %s\n", optarg);
+	return 1;
+      }
+      break;
+    case 'm':
+      options.merge = 1;
+      break;
+    case 'c':
+      options.resume = 1;
+      break;
+    default:
+      printf(USAGE, argv[0]);
+      return 1;
+    }
+  }
+  if ( optind >= argc ) {
+    printf(USAGE, argv[0]);
+    return 1;
+  }
+
+  //keep stdout for the frames or replies and send everything
+  //else to stderr
+  if ( options.y4m_file && !strcmp(options.y4m_file, "-") ) {
+    options.y4m_fd = dup(STDOUT_FILENO);
+    dup2(STDERR_FILENO, STDOUT_FILENO);
+  }
+  else if ( options.serve && !options.socket_path ) {
+    options.reply_fd = dup(STDOUT_FILENO);
+    dup2(STDERR_FILENO, STDOUT_FILENO);
+  }
+
+  options.script_file = argv[optind];
+  yyin = fopen(argv[optind],"r");
+  if ( yyin == NULL ) {
+    printf("Error: could not open %s\n", argv[optind]);
+    return 1;
+  }
+
+  grow_ops();
   yyparse();
   //COMMENT OUT PRINT_PCODE AND UNCOMMENT
   //MY_MAIN IN ORDER TO RUN YOUR CODE
   
   //print_pcode();
-  my_main();
-
-  return 0;    
+  return my_main();
 }
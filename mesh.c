@@ -0,0 +1,425 @@
+/*====================== mesh.c ========================
+Loading of meshes for the mesh command.
+
+Meshes are kept in a compact indexed binary format (see mesh.h)
+that is memory mapped and used in place. OBJ files are parsed
+once and converted to a binary cache file next to them, so the
+text is only read again when the OBJ changes.
+Neither the conversion nor drawing (in batches of MESH_BATCH
+triangles) holds the whole mesh in memory.
+==================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "mesh.h"
+
+/*======== struct mesh * map_fd() ==========
+Inputs:   int fd
+          char *filename
+Returns: The mesh stored in the binary mesh file open on fd,
+         or NULL if it can't be read
+
+The file is mapped read only and the returned vertices and
+triangles point straight into the mapping, which outlives fd.
+Every vertex index is checked once here, so drawing can use
+them unchecked. filename is only used in errors.
+====================*/
+static struct mesh * map_fd( int fd, char *filename ) {
+
+  struct stat st;
+  void *map;
+  struct mesh_header *h;
+  struct mesh *m;
+  size_t needed, i, n;
+  const int *triangles;
+
+  if ( fstat(fd, &st) < 0 || st.st_size < (off_t)sizeof(struct mesh_header) ) {
+    printf("Error: %s is not a mesh file\n", filename);
+    return NULL;
+  }
+  map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if ( map == MAP_FAILED ) {
+    printf("Error: could not map mesh %s\n", filename);
+    return NULL;
+  }
+
+  h = (struct mesh_header *)map;
+  needed = sizeof(struct mesh_header) +
+    (size_t)h->num_vertices * 3 * sizeof(float) +
+    (size_t)h->num_triangles * 3 * sizeof(int);
+  if ( memcmp(h->magic, MESH_MAGIC, 4) || h->version != MESH_VERSION ||
+       h->num_vertices < 0 || h->num_triangles < 0 ||
+       needed > (size_t)st.st_size ) {
+    printf("Error: %s is not a valid mesh file\n", filename);
+    munmap(map, st.st_size);
+    return NULL;
+  }
+
+  //a stale or damaged file mustn't send drawing outside the vertices
+  triangles = (const int *)((const float *)(h + 1) + 3 * (size_t)h->num_vertices);
+  n = 3 * (size_t)h->num_triangles;
+  for ( i=0; i < n; i++ )
+    if ( triangles[i] < 0 || triangles[i] >= h->num_vertices ) {
+      printf("Error: %s has a triangle with a bad vertex index\n", filename);
+      munmap(map, st.st_size);
+      return NULL;
+    }
+
+  m = (struct mesh *)malloc(sizeof(struct mesh));
+  m->map = map;
+  m->size = st.st_size;
+  m->num_vertices = h->num_vertices;
+  m->num_triangles = h->num_triangles;
+  m->vertices = (const float *)(h + 1);
+  m->triangles = (const int *)(m->vertices + 3 * (size_t)h->num_vertices);
+  return m;
+}
+
+/*======== struct mesh * map_mesh() ==========
+Inputs:   char *filename
+Returns: The mesh stored in the binary mesh file filename,
+         or NULL if it can't be read
+====================*/
+static struct mesh * map_mesh( char *filename ) {
+
+  int fd;
+  struct mesh *m;
+
+  fd = open(filename, O_RDONLY);
+  if ( fd < 0 ) {
+    printf("Error: could not open mesh %s\n", filename);
+    return NULL;
+  }
+  m = map_fd(fd, filename);
+  close(fd);
+  return m;
+}
+
+/*======== int cache_current() ==========
+Inputs:   char *cache
+          struct stat *obj
+Returns: 1 if the mesh file cache was made from an OBJ of the
+         size and modification time in obj, 0 otherwise
+====================*/
+static int cache_current( char *cache, struct stat *obj ) {
+
+  struct mesh_header h;
+  int fd, got;
+
+  fd = open(cache, O_RDONLY);
+  if ( fd < 0 )
+    return 0;
+  got = read(fd, &h, sizeof(h)) == (ssize_t)sizeof(h);
+  close(fd);
+  return got && !memcmp(h.magic, MESH_MAGIC, 4) && h.version == MESH_VERSION &&
+    h.source_size == (long long)obj->st_size &&
+    h.source_sec == (long long)obj->st_mtim.tv_sec &&
+    h.source_nsec == (int)obj->st_mtim.tv_nsec;
+}
+
+/*======== int parse_index() ==========
+Inputs:   char **p
+          int num_vertices
+Returns: The 0-based vertex index of the next face corner
+         at *p, or -1 if there are no more
+
+Skips the texture and normal parts of v/vt/vn corners, and
+resolves negative (relative) OBJ indices.
+====================*/
+static int parse_index( char **p, int num_vertices ) {
+
+  char *end;
+  long i;
+
+  while ( **p == ' ' || **p == '\t' )
+    (*p)++;
+  i = strtol(*p, &end, 10);
+  if ( end == *p )
+    return -1;
+  *p = end;
+  while ( **p && **p != ' ' && **p != '\t' && **p != '\n' && **p != '\r' )
+    (*p)++;
+
+  if ( i < 0 )
+    i += num_vertices;
+  else
+    i--;
+  if ( i < 0 || i >= num_vertices )
+    return -2;
+  return (int)i;
+}
+
+/*
+  Fixed size window over a file, handed out one line at a time.
+  A line cut off by the end of the window is moved to the front
+  before the next chunk is read behind it.
+*/
+struct chunk_reader {
+  FILE *f;
+  char buf[MESH_CHUNK + 1];
+  size_t start, len;
+  int eof;
+};
+
+/*======== char * next_line() ==========
+Inputs:   struct chunk_reader *r
+Returns: The next line of the file (without its newline),
+         or NULL at the end of the file
+
+Lines longer than MESH_CHUNK are split.
+====================*/
+static char * next_line( struct chunk_reader *r ) {
+
+  char *line, *nl;
+
+  for (;;) {
+    line = r->buf + r->start;
+    nl = memchr(line, '\n', r->len - r->start);
+    if ( nl ) {
+      *nl = 0;
+      r->start = nl - r->buf + 1;
+      return line;
+    }
+    if ( r->eof ) {
+      if ( r->start == r->len )
+	return NULL;
+      r->buf[r->len] = 0;
+      r->start = r->len;
+      return line;
+    }
+    //a full window with no newline, hand it out as is
+    if ( r->start == 0 && r->len == MESH_CHUNK ) {
+      r->buf[r->len] = 0;
+      r->start = r->len;
+      return line;
+    }
+    //keep the partial line and read the next chunk behind it
+    memmove(r->buf, line, r->len - r->start);
+    r->len -= r->start;
+    r->start = 0;
+    size_t got = fread(r->buf + r->len, 1, MESH_CHUNK - r->len, r->f);
+    r->len += got;
+    if ( got == 0 )
+      r->eof = 1;
+  }
+}
+
+/*======== int copy_file() ==========
+Inputs:   FILE *from
+          FILE *to
+Returns: 0 on success, -1 on failure
+
+Copies the rest of from onto to, one chunk at a time
+====================*/
+static int copy_file( FILE *from, FILE *to ) {
+
+  char *buf = (char *)malloc(MESH_CHUNK);
+  size_t got;
+  int ok = 1;
+
+  while ( ok && (got = fread(buf, 1, MESH_CHUNK, from)) > 0 )
+    ok = fwrite(buf, 1, got, to) == got;
+  free(buf);
+  return ok ? 0 : -1;
+}
+
+/*======== int write_mesh() ==========
+Inputs:   char *obj
+          FILE *f
+Returns: 0 on success, -1 on failure
+
+Converts the vertices (v) and faces (f) of the OBJ file obj to
+the binary mesh format, written to f from its start. Faces with
+more than 3 corners are split into a fan of triangles.
+
+The OBJ is streamed in MESH_CHUNK sized pieces. Vertices are
+written out as they are parsed, behind a header that is filled
+in at the end, while triangles go to a scratch file that is
+appended afterwards. Memory use therefore doesn't depend on the
+size of the mesh.
+====================*/
+static int write_mesh( char *obj, FILE *f ) {
+
+  struct chunk_reader *r;
+  struct stat st;
+  FILE *tris;
+  char *line;
+  float v[3];
+  int t[3];
+  struct mesh_header h;
+  int nv = 0, nt = 0;
+  int ok = 1;
+
+  r = (struct chunk_reader *)calloc(1, sizeof(struct chunk_reader));
+  r->f = fopen(obj, "r");
+  if ( r->f == NULL || fstat(fileno(r->f), &st) < 0 ) {
+    printf("Error: could not open mesh %s\n", obj);
+    if ( r->f )
+      fclose(r->f);
+    free(r);
+    return -1;
+  }
+  tris = tmpfile();
+  if ( tris == NULL ) {
+    fclose(r->f);
+    free(r);
+    return -1;
+  }
+
+  //placeholder, rewritten once the counts are known
+  memset(&h, 0, sizeof(h));
+  ok = fwrite(&h, sizeof(h), 1, f) == 1;
+
+  while ( ok && (line = next_line(r)) ) {
+
+    if ( line[0] == 'v' && (line[1] == ' ' || line[1] == '\t') ) {
+      if ( sscanf(line + 2, "%f %f %f", v, v + 1, v + 2) == 3 ) {
+	ok = fwrite(v, sizeof(float), 3, f) == 3;
+	nv++;
+      }
+    }
+
+    else if ( line[0] == 'f' && (line[1] == ' ' || line[1] == '\t') ) {
+      char *p = line + 2;
+
+      t[0] = parse_index(&p, nv);
+      t[1] = parse_index(&p, nv);
+      while ( ok && t[0] >= 0 && t[1] >= 0 && (t[2] = parse_index(&p, nv)) >= 0 ) {
+	ok = fwrite(t, sizeof(int), 3, tris) == 3;
+	nt++;
+	t[1] = t[2];
+      }
+    }
+  }
+  fclose(r->f);
+  free(r);
+
+  if ( ok ) {
+    rewind(tris);
+    ok = copy_file(tris, f) == 0;
+  }
+  fclose(tris);
+  if ( ok ) {
+    memcpy(h.magic, MESH_MAGIC, 4);
+    h.version = MESH_VERSION;
+    h.num_vertices = nv;
+    h.num_triangles = nt;
+    h.source_size = st.st_size;
+    h.source_sec = st.st_mtim.tv_sec;
+    h.source_nsec = st.st_mtim.tv_nsec;
+    ok = fseek(f, 0, SEEK_SET) == 0 && fwrite(&h, sizeof(h), 1, f) == 1 &&
+      fflush(f) == 0;
+  }
+  return ok ? 0 : -1;
+}
+
+/*======== int convert_obj() ==========
+Inputs:   char *obj
+          char *out
+Returns: 0 on success, -1 on failure
+
+Converts the OBJ file obj to the binary mesh file out (see
+write_mesh). The file is written under a temporary name and
+renamed into place, so a partly written cache is never picked
+up.
+====================*/
+int convert_obj( char *obj, char *out ) {
+
+  FILE *f;
+  char tmpname[512];
+  int ok;
+
+  snprintf(tmpname, sizeof(tmpname), "%s.tmp", out);
+  f = fopen(tmpname, "w+b");
+  if ( f == NULL ) {
+    printf("Error: could not write mesh cache %s\n", out);
+    return -1;
+  }
+  ok = write_mesh(obj, f) == 0;
+  ok = (fclose(f) == 0) && ok;
+
+  if ( !ok || rename(tmpname, out) ) {
+    printf("Error: could not write mesh cache %s\n", out);
+    unlink(tmpname);
+    return -1;
+  }
+  return 0;
+}
+
+/*======== struct mesh * convert_unnamed() ==========
+Inputs:   char *obj
+Returns: The mesh in the OBJ file obj, or NULL if it can't be
+         converted
+
+Converts obj into an unnamed temporary file and maps that, for
+when no cache can be kept next to the OBJ. Nothing is left
+behind once the mesh is freed.
+====================*/
+static struct mesh * convert_unnamed( char *obj ) {
+
+  FILE *f;
+  struct mesh *m = NULL;
+
+  f = tmpfile();
+  if ( f == NULL ) {
+    printf("Error: could not convert mesh %s\n", obj);
+    return NULL;
+  }
+  if ( write_mesh(obj, f) == 0 )
+    m = map_fd(fileno(f), obj);
+  else
+    printf("Error: could not convert mesh %s\n", obj);
+  fclose(f);
+  return m;
+}
+
+/*======== struct mesh * load_mesh() ==========
+Inputs:   char *filename
+Returns: The mesh in filename, or NULL if it can't be loaded
+
+Binary mesh files (ending in MESH_CACHE_EXT) are mapped
+directly. Anything else is read as an OBJ file through its
+cache, which is (re)built first unless it was made from an OBJ
+of the same size and modification time. If the cache can't be
+written (a read only directory, say) the OBJ is converted for
+this run only.
+====================*/
+struct mesh * load_mesh( char *filename ) {
+
+  char cache[512];
+  struct stat objst;
+  size_t len = strlen(filename);
+  size_t extlen = strlen(MESH_CACHE_EXT);
+
+  if ( len > extlen && !strcmp(filename + len - extlen, MESH_CACHE_EXT) )
+    return map_mesh(filename);
+
+  if ( stat(filename, &objst) < 0 ) {
+    printf("Error: could not open mesh %s\n", filename);
+    return NULL;
+  }
+  snprintf(cache, sizeof(cache), "%s%s", filename, MESH_CACHE_EXT);
+  if ( !cache_current(cache, &objst) && convert_obj(filename, cache) ) {
+    printf("Converting %s without a cache\n", filename);
+    return convert_unnamed(filename);
+  }
+  return map_mesh(cache);
+}
+
+/*======== void free_mesh() ==========
+Inputs:   struct mesh *m
+Returns:
+
+Unmaps the mesh file and frees m
+====================*/
+void free_mesh( struct mesh *m ) {
+
+  munmap(m->map, m->size);
+  free(m);
+}
@@ -0,0 +1,50 @@
+#ifndef MESH_H
+#define MESH_H
+
+#include <stddef.h>
+
+/*
+  Binary mesh files hold a mesh_header followed by num_vertices
+  float triples (x, y, z) and num_triangles int triples of
+  0-based vertex indices.
+
+  OBJ files are converted to this format once, into a cache file
+  named after the OBJ with MESH_CACHE_EXT added, and the cache is
+  memory mapped on every later load. The cache records the size
+  and modification time (to the nanosecond) of the OBJ it was
+  made from, and is rebuilt unless both still match.
+*/
+#define MESH_MAGIC "MDLM"
+#define MESH_VERSION 2
+#define MESH_CACHE_EXT ".mesh"
+
+//bytes of an OBJ file read at a time while converting it
+#define MESH_CHUNK (1 << 20)
+//triangles transformed and drawn at a time
+#define MESH_BATCH 4096
+
+struct mesh_header {
+  char magic[4];
+  int version;
+  int num_vertices;
+  int num_triangles;
+  long long source_size;  /* the OBJ converted from, 0 if none */
+  long long source_sec;
+  int source_nsec;
+  int reserved;
+};
+
+struct mesh {
+  void *map;
+  size_t size;
+  int num_vertices;
+  int num_triangles;
+  const float *vertices;
+  const int *triangles;
+};
+
+struct mesh * load_mesh( char *filename );
+void free_mesh( struct mesh *m );
+int convert_obj( char *obj, char *out );
+
+#endif
@@ -38,12 +38,13 @@ typedef struct point_t color;
 
 /*
   Likewise, we can use screen as a data type representing
-  an XRES x YRES array of colors.
+  an XRES x YRES array of colors. It is stored row by row
+  (s[y][x]) so that a horizontal span is contiguous in memory.
   eg:
   screen s;
   s[0][0] = c;
 */
-typedef struct point_t screen[XRES][YRES];
-typedef double zbuffer[XRES][YRES];
+typedef struct point_t screen[YRES][XRES];
+typedef double zbuffer[YRES][XRES];
 
 #endif
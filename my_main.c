@@ -39,6 +39,8 @@
 #include <stdlib.h>
 #include <math.h>
 #include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
 #include "parser.h"
 #include "symtab.h"
 #include "y.tab.h"
@@ -48,7 +50,14 @@
 #include "display.h"
 #include "draw.h"
 #include "stack.h"
-#define MAXLIGHTSOURCES 500
+#include "mesh.h"
+#include "bytecode.h"
+#include "output.h"
+#include "server.h"
+
+//every mesh loaded by load_resources
+static struct mesh **meshes;
+static int num_meshes;
 
 /*======== void first_pass() ==========
   Inputs:   
@@ -88,7 +97,7 @@ void first_pass() {
       strncpy( name, op[i].op.basename.p->name, sizeof( name ) );
       name_check = 1;
     }
-    else if (op[i].opcode == VARY) {
+    else if (op[i].opcode == VARY || op[i].opcode == TWEEN) {
       vary_check = 1;
     }
 
@@ -103,39 +112,82 @@ void first_pass() {
   }
 }
 
-/*======== struct vary_node ** second_pass() ==========
+/*======== struct knob_table * second_pass() ==========
   Inputs:   
-  Returns: An array of vary_node linked lists
+  Returns: The knob values for every frame
 
   In order to set the knobs for animation, we need to keep
-  a seaprate value for each knob for each frame. We can do
-  this by using an array of linked lists. Each array index
-  will correspond to a frame (eg. knobs[0] would be the first
-  frame, knobs[2] would be the 3rd frame and so on).
-
-  Each index should contain a linked list of vary_nodes, each
-  node contains a knob name, a value, and a pointer to the
-  next node.
-
-  Go through the opcode array, and when you find vary, go 
-  from knobs[0] to knobs[frames-1] and add (or modify) the
-  vary_node corresponding to the given knob with the
-  appropirate value. 
-
-  jdyrlandweaver
+  a separate value for each knob for each frame. These are
+  kept in a dense table with a row per frame and a column per
+  knob slot, so setting the knobs for a frame is a single row
+  copy.
+
+  save_knobs stores the values set so far (by set and
+  setknobs) under its knob list. Knobs that are varied start at
+  0 in every frame, every other knob at the last value it was
+  set to. Then, in order, vary fills its knob's column from
+  start_frame to end_frame and tween fills whole rows by
+  interpolating between two saved knob lists.
+
+  When animating, set and setknobs are therefore only used
+  here, and not again in the frame loop.
   ====================*/
-struct vary_node ** second_pass() {
+struct knob_table * second_pass() {
 
-  int i, k;
+  int i, k, f;
   int start_frame, end_frame;
-  double start_value, end_value, delta;  
-  struct vary_node *curr = NULL;
-  struct vary_node **knobs;
-  knobs = (struct vary_node **)calloc(num_frames, sizeof(struct vary_node *));
+  double start_value, end_value, delta;
+  double *row, *l0, *l1, *current;
+  char *varied;
+  SYMTAB *p;
+  struct knob_table *t;
+
+  t = (struct knob_table *)malloc(sizeof(struct knob_table));
+  t->num_frames = num_frames;
+  t->num_knobs = num_knobs;
+  t->values = (double *)malloc((size_t)num_frames * num_knobs * sizeof(double));
+  current = (double *)calloc(num_knobs + 1, sizeof(double));
+  varied = (char *)calloc(num_knobs + 1, 1);
+
+  //values set so far at each save_knobs, and which knobs are varied
+  for (i=0; i<lastop; i++) {
+    switch (op[i].opcode) {
+
+    case SET:
+      if (op[i].op.set.knob >= 0)
+	current[op[i].op.set.knob] = op[i].op.set.val;
+      break;
+
+    case SETKNOBS:
+      for (k=0; k < num_knobs; k++)
+	current[k] = op[i].op.setknobs.value;
+      break;
+
+    case SAVE_KNOBS:
+      p = op[i].op.save_knobs.p;
+      if (p->s.knobs == NULL)
+	p->s.knobs = (double *)malloc((num_knobs + 1) * sizeof(double));
+      memcpy(p->s.knobs, current, num_knobs * sizeof(double));
+      break;
+
+    case VARY:
+      if (op[i].op.vary.knob >= 0)
+	varied[op[i].op.vary.knob] = 1;
+      break;
+    }
+  }
 
+  for (f=0; f < num_frames; f++) {
+    row = t->values + (size_t)f * num_knobs;
+    for (k=0; k < num_knobs; k++)
+      row[k] = varied[k] ? 0 : current[k];
+  }
+
+  //later vary and tween commands overwrite earlier ones
   for (i=0; i<lastop; i++) {
-    if (op[i].opcode == VARY) {
+    switch (op[i].opcode) {
 
+    case VARY:
       start_frame = op[i].op.vary.start_frame;
       end_frame = op[i].op.vary.end_frame;
       start_value = op[i].op.vary.start_val;
@@ -149,41 +201,278 @@ struct vary_node ** second_pass() {
 	exit(-1);
       }
       //set knob values for each frame
-      for (k=0; k < num_frames; k++ ) {
-	char found = 0;
-	curr = knobs[k];
-
-	while ( curr ) {
-	  if (strncmp( curr->name, op[i].op.vary.p->name,
-		       sizeof(curr->name)) == 0 ) {
-	    found = 1;
-	    break;
-	  } //end found
-	  curr = curr->next;
-	}//end while
-
-	//make new if needed and put it at the front of the list
-	if ( !found )  {
-	  curr = (struct vary_node*)calloc(1, sizeof(struct vary_node));
-	  strncpy( curr->name, op[i].op.vary.p->name,
-		   sizeof(curr->name));
-	  curr->value = 0;
-	  curr->next = knobs[k];
-	  knobs[k] = curr;
-	}
-
-	if ( k == start_frame )
-	  curr->value = start_value;
-	
-	else if ( k > start_frame && k <= end_frame )
-	  curr->value = start_value + (k - start_frame) * delta;
-	
-	//printf("knob: %s\t%lf\n", curr->name, curr->value);
+      k = op[i].op.vary.knob;
+      if (k < 0)
+	break;
+      for (f=0; f < num_frames; f++ ) {
+	if ( f == start_frame )
+	  t->values[(size_t)f * num_knobs + k] = start_value;
+	else if ( f > start_frame && f <= end_frame )
+	  t->values[(size_t)f * num_knobs + k] = start_value + (f - start_frame) * delta;
       }//end frame loop
-    }//end if vary
+      break;
+
+    case TWEEN:
+      start_frame = op[i].op.tween.start_frame;
+      end_frame = op[i].op.tween.end_frame;
+      l0 = op[i].op.tween.knob_list0->s.knobs;
+      l1 = op[i].op.tween.knob_list1->s.knobs;
+
+      if (l0 == NULL || l1 == NULL) {
+	printf("Error: tween uses a knob list that wasn't saved: %s\n",
+	       l0 == NULL ? op[i].op.tween.knob_list0->name :
+	       op[i].op.tween.knob_list1->name);
+	exit(-1);
+      }
+      if (end_frame < start_frame) {
+	printf("Error: end frame is before start frame for tween\n");
+	exit(-1);
+      }
+      for (f=start_frame; f <= end_frame && f < num_frames; f++) {
+	if (f < 0)
+	  continue;
+	delta = end_frame > start_frame ?
+	  (double)(f - start_frame) / (end_frame - start_frame) : 0;
+	row = t->values + (size_t)f * num_knobs;
+	for (k=0; k < num_knobs; k++)
+	  row[k] = l0[k] + (l1[k] - l0[k]) * delta;
+      }
+      break;
+    }
   }//end for 
-  
-  return knobs;
+
+  free(current);
+  free(varied);
+  return t;
+}
+
+/*======== void free_knob_table() ==========
+  Inputs:   struct knob_table *t
+  Returns: 
+
+  Frees the table made by second_pass
+  ====================*/
+void free_knob_table( struct knob_table *t ) {
+
+  free(t->values);
+  free(t);
+}
+
+/*======== char * animated_knobs() ==========
+  Inputs:   struct knob_table *t
+  Returns: A flag for each knob slot, set if the knob's value
+  isn't the same in every frame of t
+  ====================*/
+char * animated_knobs( struct knob_table *t ) {
+
+  char *animated;
+  int f, k;
+
+  animated = (char *)calloc(t->num_knobs + 1, 1);
+  for (f=1; f < t->num_frames; f++)
+    for (k=0; k < t->num_knobs; k++)
+      if ( t->values[(size_t)f * t->num_knobs + k] != t->values[k] )
+	animated[k] = 1;
+  return animated;
+}
+
+/*======== int frame_range() ==========
+  Inputs:   int *first
+            int *last
+  Returns: 0, or -1 (with an error) if the frames given with -f
+           aren't all in the animation or the shard given
+           with -n has none
+
+  Sets *first and *last to the frames this run draws: all of
+  them, the ones given with -f, or one shard's share given
+  with -n. Shards are n runs of consecutive frames whose
+  lengths differ by at most one, worked out from num_frames
+  alone, so each frame belongs to exactly one shard wherever
+  it is computed. Knob values come from the whole animation's
+  knob table either way, so a frame is drawn the same by any
+  shard.
+  ====================*/
+int frame_range( int *first, int *last ) {
+
+  *first = 0;
+  *last = num_frames - 1;
+
+  if ( options.num_shards > 0 ) {
+    if ( options.shard < 0 || options.shard >= options.num_shards ) {
+      printf("Error: shards are 0 to %d\n", options.num_shards - 1);
+      return -1;
+    }
+    *first = (int)((long long)num_frames * options.shard / options.num_shards);
+    *last = (int)((long long)num_frames * (options.shard + 1) / options.num_shards) - 1;
+    if ( *last < *first ) {
+      printf("Error: shard %d of %d has no frames, there are only %d\n",
+	     options.shard, options.num_shards, num_frames);
+      return -1;
+    }
+  }
+  else if ( options.first_frame >= 0 ) {
+    if ( options.last_frame >= num_frames ) {
+      printf("Error: frames are 0 to %d\n", num_frames - 1);
+      return -1;
+    }
+    *first = options.first_frame;
+    *last = options.last_frame;
+  }
+  return 0;
+}
+
+/*======== void frame_file_name() ==========
+  Inputs:   char *file
+            int f
+  Returns: 
+
+  Puts the name frame f of the animation is saved as in file
+  ====================*/
+void frame_file_name( char *file, int f ) {
+
+  sprintf(file, "anim/%s%03d.png", name, f);
+}
+
+/*======== int merge_frames() ==========
+  Inputs:   
+  Returns: 0 if the animation was made, -1 if frames are missing
+
+  Makes the animation out of the frames saved by runs that
+  each drew some of them (-f or -n), once all are there
+  ====================*/
+int merge_frames() {
+
+  char file[128];
+  int f, missing = 0;
+
+  for (f=0; f < num_frames; f++) {
+    frame_file_name(file, f);
+    if ( access(file, F_OK) ) {
+      printf("Missing frame %d: %s\n", f, file);
+      missing++;
+    }
+  }
+  if ( missing ) {
+    printf("Error: %d of %d frames missing, not making the animation\n",
+	   missing, num_frames);
+    return -1;
+  }
+  make_animation(name);
+  return 0;
+}
+
+/*======== unsigned long hash_bytes() ==========
+  Inputs:   unsigned long h
+            void *p
+            size_t n
+  Returns: h with the n bytes at p folded in (FNV-1a)
+  ====================*/
+static unsigned long hash_bytes( unsigned long h, void *p, size_t n ) {
+
+  unsigned char *b = (unsigned char *)p;
+
+  while ( n-- ) {
+    h^= *b++;
+    h*= 1099511628211UL;
+  }
+  return h;
+}
+
+/*======== unsigned long scene_hash() ==========
+  Inputs:   
+  Returns: A hash of the script, the number of frames and the
+           size and modification time of each mesh file
+
+  Used to tell whether a journal of saved frames belongs to
+  this version of the scene. Mesh files are only stat'ed, not
+  read, so hashing stays cheap however big they are.
+  ====================*/
+unsigned long scene_hash() {
+
+  FILE *f;
+  unsigned long h = 14695981039346656037UL;
+  char buf[4096];
+  long long st_info[3];
+  struct stat st;
+  size_t n;
+  int i;
+
+  f = fopen(options.script_file, "r");
+  if ( f ) {
+    while ( (n = fread(buf, 1, sizeof(buf), f)) > 0 )
+      h = hash_bytes(h, buf, n);
+    fclose(f);
+  }
+  h = hash_bytes(h, &num_frames, sizeof(num_frames));
+
+  for (i=0; i < lastop; i++)
+    if ( op[i].opcode == MESH && !stat(op[i].op.mesh.name, &st) ) {
+      st_info[0] = st.st_size;
+      st_info[1] = st.st_mtim.tv_sec;
+      st_info[2] = st.st_mtim.tv_nsec;
+      h = hash_bytes(h, st_info, sizeof(st_info));
+    }
+  return h;
+}
+
+/*======== void load_resources() ==========
+  Inputs:   
+  Returns: 
+
+  Loads every external resource the script refers to, once,
+  before any frame is drawn. Right now those are the files of
+  the mesh commands (constants and lights already live in the
+  symbol table after parsing, and textures aren't drawn).
+
+  Each distinct mesh file is loaded a single time and the
+  resulting read only mesh is stored in op[i].op.mesh.data of
+  every mesh command using it, so all frames share it and
+  nothing is reloaded in the frame loop.
+  ====================*/
+void load_resources() {
+
+  int i, j;
+
+  meshes = (struct mesh **)calloc(lastop, sizeof(struct mesh *));
+  num_meshes = 0;
+
+  for (i=0;i<lastop;i++) {
+    if (op[i].opcode != MESH)
+      continue;
+
+    //reuse what an earlier command naming the same file got, even
+    //if it failed to load, so the error is only printed once
+    op[i].op.mesh.data = NULL;
+    for (j=0; j < i; j++)
+      if (op[j].opcode == MESH &&
+	  !strcmp(op[j].op.mesh.name, op[i].op.mesh.name)) {
+	op[i].op.mesh.data = op[j].op.mesh.data;
+	break;
+      }
+
+    if (j == i) {
+      op[i].op.mesh.data = load_mesh(op[i].op.mesh.name);
+      if (op[i].op.mesh.data)
+	meshes[num_meshes++] = op[i].op.mesh.data;
+    }
+  }
+}
+
+/*======== void free_resources() ==========
+  Inputs:   
+  Returns: 
+
+  Releases everything load_resources loaded
+  ====================*/
+void free_resources() {
+
+  int i;
+
+  for (i=0; i < num_meshes; i++)
+    free_mesh(meshes[i]);
+  free(meshes);
+  meshes = NULL;
+  num_meshes = 0;
 }
 
 /*======== void print_knobs() ==========
@@ -202,11 +491,11 @@ void print_knobs() {
   printf( "ID\tNAME\t\tTYPE\t\tVALUE\n" );
   for ( i=0; i < lastsym; i++ ) {
 
-    if ( symtab[i].type == SYM_VALUE ) {
-      printf( "%d\t%s\t\t", i, symtab[i].name );
+    if ( symbol_at(i)->type == SYM_VALUE ) {
+      printf( "%d\t%s\t\t", i, symbol_at(i)->name );
 
       printf( "SYM_VALUE\t");
-      printf( "%6.2f\n", symtab[i].s.value);
+      printf( "%6.2f\n", get_value(symbol_at(i)));
     }
   }
 }
@@ -225,13 +514,35 @@ void print2DArray(double ** a, int M, int N)
 	}
 }
 
-/*======== void my_main() ==========
+/*======== int my_main() ==========
   Inputs: 
-  Returns: 
+  Returns: 0 on success, 1 if anything asked for couldn't be
+           done (the exit status)
 
   This is the main engine of the interpreter, it should
   handle most of the commadns in mdl.
 
+  The ops are compiled once (see bytecode.c) and the
+  resulting program is run for every frame. When animating,
+  the shapes that don't depend on any animated knob are drawn
+  once into a static layer, and only the rest are drawn per
+  frame. Each frame starts from the last one with just the
+  areas the last frame's animated shapes covered restored from
+  the static layer, so the work per frame follows the area that
+  changes rather than the whole screen. Finished frames are
+  saved by encoder threads (see output.c) while the next one
+  is drawn, or written to the raw frame file given with -r
+  and/or streamed as video to the file given with -y. With -s
+  each finished frame is also published to shared memory, and
+  with -p still images are drawn in coarse preview passes first,
+  shown in shared memory.
+  With -i or -u nothing is drawn up front; the scene is served
+  instead, and with -b the images of a batch file are drawn
+  (see server.c). -f and -n draw only some of the frames, for
+  the animation to be made later with -m (see frame_range).
+  With -c, frames are recorded in a journal in anim/ as they are
+  saved, and a later run skips the ones already there.
+
   If frames is not present in the source (and therefore 
   num_frames is 1, then process_knobs should be called.
 
@@ -254,338 +565,160 @@ void print2DArray(double ** a, int M, int N)
 
   jdyrlandweaver
   ====================*/
-void my_main() {
+int my_main() {
 
   int debugMain = 1;
+  int status = 0;
 
-  struct vary_node ** knobs;
-  struct vary_node * vn;
-  first_pass();
-  knobs = second_pass();
+  struct knob_table * knobs;
+  struct program * prog;
+  char * animated;
   char frame_name[128];
-  int f;
-  
-  int i, j;
-  struct matrix *tmp;
-  struct stack *systems;
+  int f, first, last, drawn = 0;
+  struct stat st;
   screen t;
   zbuffer zb;
-  color c_Default;
-  double step = 0.01;
-  double scanLineStep = 0.01;
-  double theta;
-  double knob_value, xval, yval, zval;
-  
-  c_Default.red = 0;
-  c_Default.green = 255;
-  c_Default.blue = 0;
-
-  print_pcode();
-  ////////////////////////////////////////////LIGHTING/SHADING PASS////////////////////////////////////////////
-  char * shadingType = NULL;
-  color c_Ambient; c_Ambient.red = 0; c_Ambient.green = 0; c_Ambient.blue = 0;
-
-  //light of point sources of light
-  double ** lightSources = calloc(MAXLIGHTSOURCES, sizeof(double *));
-  int lS;
-  for(lS = 0; lS < MAXLIGHTSOURCES; lS++)
-  {
-  	lightSources[lS] = calloc(6, sizeof(double));
-  	int field;
-  	for(field = 0; field < 6; field++) lightSources[lS][field] = 0;
+  color (*static_s)[XRES] = NULL;
+  double (*static_zb)[XRES] = NULL;
+  struct output_queue *out = NULL;
+  struct raw_frames *raw = NULL;
+  struct y4m_stream *video = NULL;
+  struct journal *journal = NULL;
+
+  if ( options.shm_name )
+    open_shared_display( options.shm_name );
+  first_pass();
+  if ( options.merge ) {
+    status = merge_frames() ? 1 : 0;
+    close_shared_display();
+    return status;
   }
-  int nextLS = 0;
-  //
-  if(debugMain) printf("true\n");
-
-  //read everything related to shading
-  int operation;
-  for(operation = 0; operation < lastop; operation++)
-  {
-  	switch(op[operation].opcode)
-  	{
-  		case SHADING:
-  			if(debugMain) printf("started shadingType\n");
-  			shadingType = op[operation].op.shading.p->name;
-  			if(debugMain) printf("finished shadingType\n");
-  			break;
-
-  		case AMBIENT:
-  			if(debugMain) printf("Started ambient\n");
-  			c_Ambient.red = (int) op[operation].op.ambient.c[0];
-  			c_Ambient.green = (int) op[operation].op.ambient.c[1];
-  			c_Ambient.blue = (int) op[operation].op.ambient.c[2];
-  			if(debugMain) printf("Ambient: (%f, %f, %f)\n", op[operation].op.ambient.c[0], op[operation].op.ambient.c[1], op[operation].op.ambient.c[2]);
-  			break;
-
-  		case LIGHT:
-  			//add to list of light sources
-  			if(debugMain) printf("Started light\n");
-  			printf("Light: %s at: %6.2f %6.2f %6.2f",
-		 		op[operation].op.light.p->name,
-		 		op[operation].op.light.p->s.l->l[0], op[operation].op.light.p->s.l->l[1],
-		 		op[operation].op.light.p->s.l->l[2]);
-  			lightSources[nextLS][0] = op[operation].op.light.p->s.l->c[0];
-  			lightSources[nextLS][1] = op[operation].op.light.p->s.l->c[1];
-  			lightSources[nextLS][2] = op[operation].op.light.p->s.l->c[2];
-  			lightSources[nextLS][3] = op[operation].op.light.p->s.l->l[0];
-  			lightSources[nextLS][4] = op[operation].op.light.p->s.l->l[1];
-  			lightSources[nextLS][5] = op[operation].op.light.p->s.l->l[2];
-  			nextLS++;
-  			if(debugMain) printf("Finished light\n");
-  			break;
-  	}
+  if ( frame_range( &first, &last ) ) {
+    close_shared_display();
+    return 1;
   }
-  if(debugMain) printf("finished shading initial pass\n");
+  knobs = second_pass();
+  load_resources();
+  prog = compile_ops();
 
-  //LIGHT SOURCES
+  print_pcode();
   if(debugMain) printf("Light Sources\n");
-  if(debugMain) print2DArray(lightSources, nextLS, 6);
+  if(debugMain) print2DArray(prog->lights, prog->num_lights, 6);
+
+  if ( options.batch_file || options.serve ) {
+    if ( options.batch_file )
+      status = run_batch( prog, knobs, t, zb, options.batch_file ) ? 1 : 0;
+    else
+      serve( prog, knobs, t, zb );
+    free_program(prog);
+    free_knob_table(knobs);
+    free_resources();
+    close_shared_display();
+    return status;
+  }
 
-  if(shadingType == NULL) shadingType = "wireframe";
-  /////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  //draw the static layer
+  if ( num_frames > 1 ) {
+    animated = animated_knobs( knobs );
+    if ( split_program( prog, animated ) ) {
+      static_s = malloc( sizeof(screen) );
+      static_zb = malloc( sizeof(zbuffer) );
+      clear_screen( static_s );
+      clear_zbuffer( static_zb );
+      set_knobs( knobs->values );
+      run_code( prog, prog->static_code, static_s, static_zb );
+    }
+    free( animated );
+  }
 
-  if(debugMain) printf("Running frames\n");
+  if(debugMain) printf("Running frames %d to %d\n", first, last);
+  if ( options.raw_file )
+    raw = open_raw_frames( options.raw_file, first, last - first + 1 );
+  if ( options.y4m_file )
+    video = open_y4m( options.y4m_file, options.y4m_fd );
+  if ( !raw && !video && num_frames > 1 ) {
+    if ( options.resume ) {
+      //runs drawing different frames (-f, -n) keep journals of their own
+      if ( first == 0 && last == num_frames - 1 )
+	sprintf( frame_name, "anim/.%s.journal", name );
+      else
+	sprintf( frame_name, "anim/.%s.%d-%d.journal", name, first, last );
+      journal = open_journal( frame_name, scene_hash(), num_frames );
+    }
+    out = start_output( journal );
+  }
+  else if ( options.resume )
+    printf("Warning: only saved image frames can be resumed\n");
 
-  for (f=0; f < num_frames; f++) {
+  for (f=first; f <= last; f++) {
 
-    systems = new_stack();
-    tmp = new_matrix(4, 1000);
-    clear_screen( t );
-    clear_zbuffer(zb);
+    //frames saved by an earlier run are skipped, if their files are
+    //still there and not empty
+    if ( journal && frame_done( journal, f ) ) {
+      frame_file_name( frame_name, f );
+      if ( !stat( frame_name, &st ) && st.st_size > 0 )
+	continue;
+    }
 
     //if there are multiple frames, set the knobs
-    if ( num_frames > 1 ) {      
-      vn = knobs[f];
-      
-      while ( vn ) {	
-	//printf("\tknob: %s value:%lf\n", vn->name, vn->value);	
-	set_value( lookup_symbol( vn->name ), vn->value );
-	vn = vn-> next;
-      } //end while knobs
-    }//end if multiple frames
-    
-    
-    for (i=0;i<lastop;i++) {
-      //printf("%d: ",i);
-      switch (op[i].opcode)
-	{
-	case SET:
-	  set_value( lookup_symbol(op[i].op.set.p->name),
-		     op[i].op.set.p->s.value);
-	  break;
-	  
-	case SETKNOBS:
-	  for ( j=0; j < lastsym; j++ ) 
-	    if ( symtab[j].type == SYM_VALUE )
-	      symtab[j].s.value = op[i].op.setknobs.value;
-	  break;
-	  
-	case SPHERE:
-	  /* printf("Sphere: %6.2f %6.2f %6.2f r=%6.2f", */
-	  /* 	 op[i].op.sphere.d[0],op[i].op.sphere.d[1], */
-	  /* 	 op[i].op.sphere.d[2], */
-	  /* 	 op[i].op.sphere.r); */
-	  if (op[i].op.sphere.constants != NULL)
-	    {
-	      //printf("\tconstants: %s",op[i].op.sphere.constants->name);
-	    }
-	  if (op[i].op.sphere.cs != NULL)
-	    {
-	      //printf("\tcs: %s",op[i].op.sphere.cs->name);
-	    }
-	  add_sphere(tmp, op[i].op.sphere.d[0],
-		     op[i].op.sphere.d[1],
-		     op[i].op.sphere.d[2],
-		     op[i].op.sphere.r, step);
-	  matrix_mult( peek(systems), tmp );
-
-	  if(strcmp(shadingType, "wireframe") == 0)
-	  {
-	  	draw_polygons(tmp, t, zb, c_Default, scanLineStep);
-	  }
-	  else if(strcmp(shadingType, "flat") == 0)
-	  {
-	  	draw_polygons_flat(tmp, t, zb, lightSources, nextLS, c_Ambient, op[i].op.sphere.constants->s.c, scanLineStep);
-	  }
-	  tmp->lastcol = 0;
-	  break;
-	case TORUS:
-	  /* printf("Torus: %6.2f %6.2f %6.2f r0=%6.2f r1=%6.2f", */
-	  /* 	 op[i].op.torus.d[0],op[i].op.torus.d[1], */
-	  /* 	 op[i].op.torus.d[2], */
-	  /* 	 op[i].op.torus.r0,op[i].op.torus.r1); */
-	  if (op[i].op.torus.constants != NULL)
-	    {
-	      //printf("\tconstants: %s",op[i].op.torus.constants->name);
-	    }
-	  if (op[i].op.torus.cs != NULL)
-	    {
-	      //printf("\tcs: %s",op[i].op.torus.cs->name);
-	    }
-	  add_torus(tmp,
-		    op[i].op.torus.d[0],
-		    op[i].op.torus.d[1],
-		    op[i].op.torus.d[2],
-		    op[i].op.torus.r0,op[i].op.torus.r1, step);
-	  matrix_mult( peek(systems), tmp );
-	  if(strcmp(shadingType, "wireframe") == 0)
-	  {
-	  	draw_polygons(tmp, t, zb, c_Default, scanLineStep);
-	  }
-	  else if(strcmp(shadingType, "flat") == 0)
-	  {
-	  	draw_polygons_flat(tmp, t, zb, lightSources, nextLS, c_Ambient, op[i].op.torus.constants->s.c, scanLineStep);
-	  }
-	  tmp->lastcol = 0;	  
-	  break;
-	case BOX:
-	  /* printf("Box: d0: %6.2f %6.2f %6.2f d1: %6.2f %6.2f %6.2f", */
-	  /* 	 op[i].op.box.d0[0],op[i].op.box.d0[1], */
-	  /* 	 op[i].op.box.d0[2], */
-	  /* 	 op[i].op.box.d1[0],op[i].op.box.d1[1], */
-	  /* 	 op[i].op.box.d1[2]); */
-	  if (op[i].op.box.constants != NULL)
-	    {
-	      //printf("\tconstants: %s",op[i].op.box.constants->name);
-	    }
-	  if (op[i].op.box.cs != NULL)
-	    {
-	      //printf("\tcs: %s",op[i].op.box.cs->name);
-	    }
-	    //printf("Making box\n");
-	  add_box(tmp,
-		  op[i].op.box.d0[0],op[i].op.box.d0[1],
-		  op[i].op.box.d0[2],
-		  op[i].op.box.d1[0],op[i].op.box.d1[1],
-		  op[i].op.box.d1[2]);
-	  matrix_mult( peek(systems), tmp );
-	  //printf("about to draw\n");
-	  if(strcmp(shadingType, "wireframe") == 0)
-	  {
-	  	draw_polygons(tmp, t, zb, c_Default, scanLineStep);
-	  }
-	  else if(strcmp(shadingType, "flat") == 0)
-	  {
-	  	draw_polygons_flat(tmp, t, zb, lightSources, nextLS, c_Ambient, op[i].op.box.constants->s.c, scanLineStep);
-	  }
-	  //printf("finished box\n");
-	  tmp->lastcol = 0;
-	  break;
-	case LINE:
-	  /* printf("Line: from: %6.2f %6.2f %6.2f to: %6.2f %6.2f %6.2f",*/
-	  /* 	 op[i].op.line.p0[0],op[i].op.line.p0[1], */
-	  /* 	 op[i].op.line.p0[1], */
-	  /* 	 op[i].op.line.p1[0],op[i].op.line.p1[1], */
-	  /* 	 op[i].op.line.p1[1]); */
-	  if (op[i].op.line.constants != NULL)
-	    {
-	      //printf("\n\tConstants: %s",op[i].op.line.constants->name);
-	    }
-	  if (op[i].op.line.cs0 != NULL)
-	    {
-	      //printf("\n\tCS0: %s",op[i].op.line.cs0->name);
-	    }
-	  if (op[i].op.line.cs1 != NULL)
-	    {
-	      //printf("\n\tCS1: %s",op[i].op.line.cs1->name);
-	    }
-	  break;
-	case MOVE:
-	  xval = op[i].op.move.d[0];
-	  yval = op[i].op.move.d[1];
-	  zval = op[i].op.move.d[2];
-	  /* printf("Move: %6.2f %6.2f %6.2f", */
-	  /* 	 xval, yval, zval); */
-	  if (op[i].op.move.p != NULL)
-	    {
-	      //printf("\tknob: %s",op[i].op.move.p->name);
-	      knob_value = lookup_symbol(op[i].op.move.p->name)->s.value;
-	      xval*= knob_value;
-	      yval*= knob_value;
-	      zval*= knob_value;	      
-	    }
-	  tmp = make_translate( xval, yval, zval );
-	  matrix_mult(peek(systems), tmp);
-	  copy_matrix(tmp, peek(systems));
-	  tmp->lastcol = 0;
-	  break;
-	case SCALE:
-	  xval = op[i].op.scale.d[0];
-	  yval = op[i].op.scale.d[1];
-	  zval = op[i].op.scale.d[2];	  
-	  /* printf("Scale: %6.2f %6.2f %6.2f", */
-	  /* 	 xval, yval, zval); */
-	  if (op[i].op.scale.p != NULL)
-	    {
-	      //printf("\tknob: %s",op[i].op.scale.p->name);
-	      knob_value = lookup_symbol(op[i].op.scale.p->name)->s.value;
-	      xval*= knob_value;
-	      yval*= knob_value;
-	      zval*= knob_value;	      
-	    }
-	  tmp = make_scale( xval, yval, zval );
-	  matrix_mult(peek(systems), tmp);
-	  copy_matrix(tmp, peek(systems));
-	  tmp->lastcol = 0;
-	  break;
-	case ROTATE:
-	  xval = op[i].op.rotate.axis;
-	  theta = op[i].op.rotate.degrees;
-	  /* printf("Rotate: axis: %6.2f degrees: %6.2f", */
-	  /* 	 xval, theta); */
-	  if (op[i].op.rotate.p != NULL)
-	    {
-	      //printf("\tknob: %s",op[i].op.rotate.p->name);
-	      knob_value = lookup_symbol(op[i].op.rotate.p->name)->s.value;
-	      theta*= knob_value;
-	    }
-	  theta*= (M_PI / 180);
-	  if (op[i].op.rotate.axis == 0 )
-	    tmp = make_rotX( theta );
-	  else if (op[i].op.rotate.axis == 1 )
-	    tmp = make_rotY( theta );
-	  else
-	    tmp = make_rotZ( theta );
-	  
-	  matrix_mult(peek(systems), tmp);
-	  copy_matrix(tmp, peek(systems));
-	  tmp->lastcol = 0;
-	  break;
-	case PUSH:
-	  //printf("Push");
-	  push(systems);
-	  break;
-	case POP:
-	  //printf("Pop");
-	  pop(systems);
-	  break;
-	case SAVE:
-	  //printf("Save: %s",op[i].op.save.p->name);
-	  save_extension(t, op[i].op.save.p->name);
-	  break;
-	case DISPLAY:
-	  //printf("Display");
-	  display(t);
-	  break;
-	} //end opcode switch
-      //printf("\n");
-    }//end operation loop
-
-    free_stack( systems );
-    free_matrix( tmp );
-    
+    if ( num_frames > 1 )
+      set_knobs( knobs->values + (size_t)f * knobs->num_knobs );
+
+    if ( static_s ) {
+      //only redo the tiles the shapes that moved since the last
+      //frame covered, or everything if this is the first one
+      plan_frame( prog );
+      if ( !drawn )
+	memset( prog->dirty, 1, TILES_X * TILES_Y );
+      copy_tiles( static_s, static_zb, t, zb, prog->dirty );
+      redraw_frame( prog, t, zb );
+    }
+    else if ( options.preview )
+      run_progressive( prog, t, zb );
+    else {
+      clear_screen( t );
+      clear_zbuffer(zb);
+      run_program( prog, t, zb );
+    }
+
+    drawn = 1;
+    publish_screen( t, f );
+    if ( raw )
+      write_raw_frame( raw, f - first, t );
+    if ( video && write_y4m_frame( video, t ) ) {
+      close_y4m( video );
+      video = NULL;
+    }
     //save the correct image name for animation
-    if (num_frames > 1) {
+    if ( out ) {
       printf("Saving Frame: %d\n", f);
-      sprintf(frame_name, "anim/%s%03d.png", name, f);
-      save_extension( t, frame_name );
+      frame_file_name( frame_name, f );
+      queue_frame( out, t, frame_name, f );
     } //end frame saving
   }//end frame loop
-
-  free2DArray(lightSources, nextLS);
-
-  //generate animated gif
-  if (num_frames > 1)
-    make_animation( name );
+  if ( out ) {
+    if ( finish_output( out ) ) {
+      printf("Error: some frames could not be saved, not making the animation\n");
+      status = 1;
+    }
+    //generate animated gif, once every frame is there
+    else if ( first == 0 && last == num_frames - 1 )
+      make_animation( name );
+    else
+      printf("Saved frames %d to %d, make the animation with -m\n", first, last);
+  }
+  if ( journal )
+    close_journal( journal );
+  if ( raw )
+    close_raw_frames( raw );
+  if ( video )
+    close_y4m( video );
+
+  free(static_s);
+  free(static_zb);
+  free_program(prog);
+  free_knob_table(knobs);
+  free_resources();
+  close_shared_display();
+  return status;
 }
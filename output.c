@@ -0,0 +1,591 @@
+/*====================== output.c ========================
+Saving of animation frames in the background.
+
+Encoding a frame and waiting on the convert process that writes
+it takes about as long as drawing it, so frames are handed to
+encoder threads through a bounded queue and saved while the
+next frame is drawn (see output.h), and optionally recorded
+in a journal once saved so an interrupted run can resume.
+
+Frames can instead be written uncompressed into a single
+memory mapped raw frame file, or streamed as YUV4MPEG2 to a
+file, pipe or stdout as they are drawn.
+==================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+
+#include "ml6.h"
+#include "display.h"
+#include "output.h"
+
+//a color channel clamped to fit a byte
+#define CHANNEL(v) ( (v) < 0 ? 0 : (v) > MAX_COLOR ? MAX_COLOR : (v) )
+
+/*======== int sync_file() ==========
+Inputs:   char *file
+Returns: 0 once file is on the disk, -1 if it can't be synced
+====================*/
+static int sync_file( char *file ) {
+
+  int fd, r;
+
+  fd = open(file, O_RDONLY);
+  if ( fd < 0 )
+    return -1;
+  r = fsync(fd);
+  close(fd);
+  return r;
+}
+
+/*======== void save_frame() ==========
+Inputs:   struct output_queue *q
+          screen s
+          char *file
+          int frame
+Returns:
+
+Saves s, animation frame frame, to file and records it in q's
+journal, or reports it and counts it in q->failed if it can't
+be saved. With a journal the file is synced first, so the
+journal never lists a frame that a crash could still cut
+short. Encoder threads may call this at the same time.
+====================*/
+static void save_frame( struct output_queue *q, screen s, char *file, int frame ) {
+
+  if ( save_extension(s, file) || (q->journal && sync_file(file)) ) {
+    printf("Error: could not save %s\n", file);
+    pthread_mutex_lock(&q->lock);
+    q->failed++;
+    pthread_mutex_unlock(&q->lock);
+  }
+  else if ( q->journal )
+    record_frame(q->journal, frame);
+}
+
+/*======== void * encode_frames() ==========
+Inputs:   void *arg
+Returns: NULL
+
+Body of each encoder thread. Saves the frames in the
+struct output_queue arg as they become ready, handing each
+buffer back once it is written, until the queue is finished
+and empty.
+====================*/
+static void * encode_frames( void *arg ) {
+
+  struct output_queue *q = (struct output_queue *)arg;
+  int b;
+
+  pthread_mutex_lock(&q->lock);
+  for (;;) {
+    while ( q->num_ready == 0 && !q->done )
+      pthread_cond_wait(&q->frame_ready, &q->lock);
+    if ( q->num_ready == 0 )
+      break;
+    b = q->ready[q->ready_head];
+    q->ready_head = (q->ready_head + 1) % q->num_buffers;
+    q->num_ready--;
+    pthread_mutex_unlock(&q->lock);
+
+    save_frame(q, q->buffers[b], q->files[b], q->frames[b]);
+
+    pthread_mutex_lock(&q->lock);
+    q->free[q->num_free++] = b;
+    pthread_cond_signal(&q->buffer_free);
+  }
+  pthread_mutex_unlock(&q->lock);
+  return NULL;
+}
+
+/*======== struct output_queue * start_output() ==========
+Inputs:   struct journal *journal
+Returns: A new output queue with its encoder threads running
+
+One encoder thread is started per cpu, up to
+OUTPUT_MAX_THREADS. If no thread can be started, frames are
+saved directly by queue_frame. Frames saved successfully are
+recorded in journal, unless it is NULL.
+====================*/
+struct output_queue * start_output( struct journal *journal ) {
+
+  struct output_queue *q;
+  long cpus;
+  int i, n;
+
+  cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  n = cpus < 1 ? 1 : cpus > OUTPUT_MAX_THREADS ? OUTPUT_MAX_THREADS : (int)cpus;
+
+  q = (struct output_queue *)calloc(1, sizeof(struct output_queue));
+  q->num_buffers = n * OUTPUT_FRAMES_PER_THREAD;
+  q->buffers = malloc(q->num_buffers * sizeof(screen));
+  q->files = malloc(q->num_buffers * sizeof(q->files[0]));
+  q->frames = (int *)malloc(q->num_buffers * sizeof(int));
+  q->journal = journal;
+  q->ready = (int *)malloc(q->num_buffers * sizeof(int));
+  q->free = (int *)malloc(q->num_buffers * sizeof(int));
+  for ( i=0; i < q->num_buffers; i++ )
+    q->free[i] = i;
+  q->num_free = q->num_buffers;
+
+  pthread_mutex_init(&q->lock, NULL);
+  pthread_cond_init(&q->frame_ready, NULL);
+  pthread_cond_init(&q->buffer_free, NULL);
+
+  q->threads = (pthread_t *)malloc(n * sizeof(pthread_t));
+  for ( i=0; i < n; i++ ) {
+    if ( pthread_create(&q->threads[i], NULL, encode_frames, q) ) {
+      printf("Warning: could not start encoder thread, saving frames directly\n");
+      break;
+    }
+    q->num_threads++;
+  }
+  return q;
+}
+
+/*======== void queue_frame() ==========
+Inputs:   struct output_queue *q
+          screen s
+          char *file
+          int frame
+Returns:
+
+Copies s, animation frame frame, to be saved to file by an
+encoder thread. Blocks
+while every buffer is still waiting to be saved, so frames
+are never drawn much faster than they are written.
+====================*/
+void queue_frame( struct output_queue *q, screen s, char *file, int frame ) {
+
+  int b;
+
+  if ( q->num_threads == 0 ) {
+    save_frame(q, s, file, frame);
+    return;
+  }
+
+  pthread_mutex_lock(&q->lock);
+  while ( q->num_free == 0 )
+    pthread_cond_wait(&q->buffer_free, &q->lock);
+  b = q->free[--q->num_free];
+  pthread_mutex_unlock(&q->lock);
+
+  memcpy(q->buffers[b], s, sizeof(screen));
+  snprintf(q->files[b], sizeof(q->files[b]), "%s", file);
+  q->frames[b] = frame;
+
+  pthread_mutex_lock(&q->lock);
+  q->ready[(q->ready_head + q->num_ready) % q->num_buffers] = b;
+  q->num_ready++;
+  pthread_cond_signal(&q->frame_ready);
+  pthread_mutex_unlock(&q->lock);
+}
+
+/*======== int finish_output() ==========
+Inputs:   struct output_queue *q
+Returns: The number of frames that couldn't be saved
+
+Waits for every queued frame to be saved, then stops the
+encoder threads and frees q
+====================*/
+int finish_output( struct output_queue *q ) {
+
+  int i, failed;
+
+  pthread_mutex_lock(&q->lock);
+  q->done = 1;
+  pthread_cond_broadcast(&q->frame_ready);
+  pthread_mutex_unlock(&q->lock);
+  for ( i=0; i < q->num_threads; i++ )
+    pthread_join(q->threads[i], NULL);
+  failed = q->failed;
+
+  pthread_mutex_destroy(&q->lock);
+  pthread_cond_destroy(&q->frame_ready);
+  pthread_cond_destroy(&q->buffer_free);
+  free(q->threads);
+  free(q->buffers);
+  free(q->files);
+  free(q->frames);
+  free(q->ready);
+  free(q->free);
+  free(q);
+  return failed;
+}
+
+/*======== struct journal * open_journal() ==========
+Inputs:   char *file
+          unsigned long hash
+          int num_frames
+Returns: The journal in file, or NULL if it can't be opened
+
+Frames an existing journal for the same scene (the same hash
+and number of frames) lists as saved are marked done. A
+journal for anything else is started over.
+====================*/
+struct journal * open_journal( char *file, unsigned long hash, int num_frames ) {
+
+  struct journal *j;
+  FILE *f;
+  char magic[8];
+  unsigned long old_hash;
+  int old_frames, frame, found = 0;
+
+  j = (struct journal *)calloc(1, sizeof(struct journal));
+  j->num_frames = num_frames;
+  j->done = (char *)calloc(num_frames, 1);
+  pthread_mutex_init(&j->lock, NULL);
+
+  f = fopen(file, "r");
+  if ( f ) {
+    if ( fscanf(f, "%7s %lx %d", magic, &old_hash, &old_frames) == 3 &&
+	 !strcmp(magic, JOURNAL_MAGIC) && old_hash == hash && old_frames == num_frames ) {
+      while ( fscanf(f, "%d", &frame) == 1 )
+	if ( frame >= 0 && frame < num_frames && !j->done[frame] ) {
+	  j->done[frame] = 1;
+	  found++;
+	}
+      printf("Resuming: %d of %d frames already saved\n", found, num_frames);
+    }
+    else
+      printf("The script changed since %s was written, starting over\n", file);
+    fclose(f);
+  }
+
+  //an up to date journal is added to, anything else replaced
+  if ( found )
+    j->f = fopen(file, "a");
+  else if ( (j->f = fopen(file, "w")) )
+    fprintf(j->f, "%s %lx %d\n", JOURNAL_MAGIC, hash, num_frames);
+  if ( j->f == NULL ) {
+    printf("Error: could not write journal %s\n", file);
+    close_journal(j);
+    return NULL;
+  }
+  fflush(j->f);
+  return j;
+}
+
+/*======== int frame_done() ==========
+Inputs:   struct journal *j
+          int frame
+Returns: Whether j lists frame as saved
+====================*/
+int frame_done( struct journal *j, int frame ) {
+
+  int done;
+
+  pthread_mutex_lock(&j->lock);
+  done = frame >= 0 && frame < j->num_frames && j->done[frame];
+  pthread_mutex_unlock(&j->lock);
+  return done;
+}
+
+/*======== void record_frame() ==========
+Inputs:   struct journal *j
+          int frame
+Returns:
+
+Adds frame to j as saved, and makes sure it reaches the disk
+before returning, so no frame is lost if the machine goes
+down right after. The frame's own file should be synced
+first. Encoder threads may call this at the same time.
+====================*/
+void record_frame( struct journal *j, int frame ) {
+
+  if ( frame < 0 || frame >= j->num_frames )
+    return;
+  pthread_mutex_lock(&j->lock);
+  if ( !j->done[frame] ) {
+    j->done[frame] = 1;
+    fprintf(j->f, "%d\n", frame);
+    fflush(j->f);
+    fsync(fileno(j->f));
+  }
+  pthread_mutex_unlock(&j->lock);
+}
+
+/*======== void close_journal() ==========
+Inputs:   struct journal *j
+Returns:
+
+Closes the journal file and frees j
+====================*/
+void close_journal( struct journal *j ) {
+
+  if ( j->f )
+    fclose(j->f);
+  pthread_mutex_destroy(&j->lock);
+  free(j->done);
+  free(j);
+}
+
+/*======== struct raw_frames * open_raw_frames() ==========
+Inputs:   char *file
+          int first_frame
+          int num_frames
+Returns: The raw frame file file, created with room for
+         num_frames frames from first_frame on and mapped, or
+         NULL if it can't be
+====================*/
+struct raw_frames * open_raw_frames( char *file, int first_frame, int num_frames ) {
+
+  int fd;
+  size_t size;
+  void *map;
+  struct raw_header *h;
+  struct raw_frames *r;
+
+  size = sizeof(struct raw_header) + (size_t)num_frames * YRES * XRES * 3;
+  fd = open(file, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if ( fd < 0 ) {
+    printf("Error: could not open raw frame file %s\n", file);
+    return NULL;
+  }
+  if ( ftruncate(fd, size) < 0 ) {
+    printf("Error: could not size raw frame file %s\n", file);
+    close(fd);
+    return NULL;
+  }
+  map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if ( map == MAP_FAILED ) {
+    printf("Error: could not map raw frame file %s\n", file);
+    return NULL;
+  }
+
+  h = (struct raw_header *)map;
+  memset(h, 0, sizeof(struct raw_header));
+  memcpy(h->magic, RAW_MAGIC, 4);
+  h->version = RAW_VERSION;
+  h->width = XRES;
+  h->height = YRES;
+  h->num_frames = num_frames;
+  h->channels = 3;
+  h->first_frame = first_frame;
+
+  r = (struct raw_frames *)malloc(sizeof(struct raw_frames));
+  r->map = (unsigned char *)map;
+  r->size = size;
+  r->num_frames = num_frames;
+  return r;
+}
+
+/*======== void write_raw_frame() ==========
+Inputs:   struct raw_frames *r
+          int frame
+          screen s
+Returns:
+
+Writes s as frame frame of r, counting from its first frame
+====================*/
+void write_raw_frame( struct raw_frames *r, int frame, screen s ) {
+
+  if ( frame < 0 || frame >= r->num_frames )
+    return;
+  screen_to_rgb(s, r->map + sizeof(struct raw_header) + (size_t)frame * YRES * XRES * 3);
+}
+
+/*======== void close_raw_frames() ==========
+Inputs:   struct raw_frames *r
+Returns:
+
+Unmaps the raw frame file, leaving the kernel to finish
+writing it back, and frees r
+====================*/
+void close_raw_frames( struct raw_frames *r ) {
+
+  munmap(r->map, r->size);
+  free(r);
+}
+
+/*======== struct y4m_stream * open_y4m() ==========
+Inputs:   char *file
+          int fd
+Returns: A YUV4MPEG2 stream writing to fd if it isn't -1,
+         otherwise to file (which may be a FIFO), or NULL
+         if it can't be opened
+
+The stream header is written right away.
+====================*/
+struct y4m_stream * open_y4m( char *file, int fd ) {
+
+  struct y4m_stream *y;
+  FILE *f;
+
+  f = fd != -1 ? fdopen(fd, "w") : fopen(file, "w");
+  if ( f == NULL ) {
+    printf("Error: could not open video stream %s\n", file);
+    return NULL;
+  }
+  //the samples are full range, which readers assume they are not
+  //unless told
+  fprintf(f, "YUV4MPEG2 W%d H%d F%s Ip A1:1 C420jpeg XCOLORRANGE=FULL\n",
+	  XRES, YRES, Y4M_RATE);
+
+  y = (struct y4m_stream *)malloc(sizeof(struct y4m_stream));
+  y->f = f;
+  y->frame_size = XRES * YRES + 2 * CHROMA_XRES * CHROMA_YRES;
+  y->frame = (unsigned char *)malloc(y->frame_size);
+  return y;
+}
+
+/*======== void luma() ==========
+Inputs:   unsigned short *r
+          unsigned short *g
+          unsigned short *b
+          unsigned char *out
+          int n
+Returns:
+
+Converts n pixels with channels 0-255 to luma:
+  Y = (77r + 150g + 29b + 128) / 256
+Eight pixels are converted at a time in 16 bit lanes with
+SSE2 (the sum never passes 65535), the rest in a plain loop.
+====================*/
+static void luma( unsigned short *r, unsigned short *g, unsigned short *b,
+		  unsigned char *out, int n ) {
+
+  int k = 0;
+
+#if defined(__SSE2__)
+  __m128i cr = _mm_set1_epi16(77);
+  __m128i cg = _mm_set1_epi16(150);
+  __m128i cb = _mm_set1_epi16(29);
+  __m128i half = _mm_set1_epi16(128);
+
+  for ( ; k + 8 <= n; k += 8 ) {
+    __m128i sum = _mm_add_epi16(half, _mm_mullo_epi16(cr, _mm_loadu_si128((__m128i *)(r + k))));
+    sum = _mm_add_epi16(sum, _mm_mullo_epi16(cg, _mm_loadu_si128((__m128i *)(g + k))));
+    sum = _mm_add_epi16(sum, _mm_mullo_epi16(cb, _mm_loadu_si128((__m128i *)(b + k))));
+    sum = _mm_srli_epi16(sum, 8);
+    _mm_storel_epi64((__m128i *)(out + k), _mm_packus_epi16(sum, sum));
+  }
+#endif
+
+  for ( ; k < n; k++ )
+    out[k] = (77 * r[k] + 150 * g[k] + 29 * b[k] + 128) >> 8;
+}
+
+/*======== void chroma() ==========
+Inputs:   unsigned short *r
+          unsigned short *g
+          unsigned short *b
+          unsigned char *u
+          unsigned char *v
+          int n
+Returns:
+
+Converts n pixels with channels 0-255 to chroma:
+  U = (32895 - 43r - 85g + 128b) / 256
+  V = (32895 + 128r - 107g - 21b) / 256
+The offset keeps each sum between 0 and 65535, so like luma
+they are computed eight at a time in unsigned 16 bit lanes.
+====================*/
+static void chroma( unsigned short *r, unsigned short *g, unsigned short *b,
+		    unsigned char *u, unsigned char *v, int n ) {
+
+  int k = 0;
+
+#if defined(__SSE2__)
+  __m128i offset = _mm_set1_epi16((short)32895);
+  __m128i c43 = _mm_set1_epi16(43);
+  __m128i c85 = _mm_set1_epi16(85);
+  __m128i c107 = _mm_set1_epi16(107);
+  __m128i c21 = _mm_set1_epi16(21);
+
+  for ( ; k + 8 <= n; k += 8 ) {
+    __m128i rv = _mm_loadu_si128((__m128i *)(r + k));
+    __m128i gv = _mm_loadu_si128((__m128i *)(g + k));
+    __m128i bv = _mm_loadu_si128((__m128i *)(b + k));
+    __m128i us = _mm_add_epi16(offset, _mm_slli_epi16(bv, 7));
+    __m128i vs = _mm_add_epi16(offset, _mm_slli_epi16(rv, 7));
+    us = _mm_sub_epi16(us, _mm_mullo_epi16(c43, rv));
+    us = _mm_sub_epi16(us, _mm_mullo_epi16(c85, gv));
+    vs = _mm_sub_epi16(vs, _mm_mullo_epi16(c107, gv));
+    vs = _mm_sub_epi16(vs, _mm_mullo_epi16(c21, bv));
+    us = _mm_srli_epi16(us, 8);
+    vs = _mm_srli_epi16(vs, 8);
+    _mm_storel_epi64((__m128i *)(u + k), _mm_packus_epi16(us, us));
+    _mm_storel_epi64((__m128i *)(v + k), _mm_packus_epi16(vs, vs));
+  }
+#endif
+
+  for ( ; k < n; k++ ) {
+    u[k] = (32895 - 43 * r[k] - 85 * g[k] + 128 * b[k]) >> 8;
+    v[k] = (32895 + 128 * r[k] - 107 * g[k] - 21 * b[k]) >> 8;
+  }
+}
+
+/*======== int write_y4m_frame() ==========
+Inputs:   struct y4m_stream *y
+          screen s
+Returns: 0 on success, -1 if the frame couldn't be written
+
+Converts s to 4:2:0 YUV and writes it as the next frame of y.
+Each row's channels are split into planes for luma, and each
+pair of rows is averaged down 2x2 for chroma (edge pixels are
+repeated when a dimension is odd).
+====================*/
+int write_y4m_frame( struct y4m_stream *y, screen s ) {
+
+  unsigned short r[XRES], g[XRES], b[XRES];
+  unsigned char *yp, *up, *vp;
+  int row, x, x1, row1;
+
+  yp = y->frame;
+  up = yp + XRES * YRES;
+  vp = up + CHROMA_XRES * CHROMA_YRES;
+
+  for ( row=0; row < YRES; row++ ) {
+    for ( x=0; x < XRES; x++ ) {
+      r[x] = CHANNEL(s[row][x].red);
+      g[x] = CHANNEL(s[row][x].green);
+      b[x] = CHANNEL(s[row][x].blue);
+    }
+    luma(r, g, b, yp + row * XRES, XRES);
+  }
+
+  for ( row=0; row < CHROMA_YRES; row++ ) {
+    row1 = 2 * row + 1 < YRES ? 2 * row + 1 : 2 * row;
+    for ( x=0; x < CHROMA_XRES; x++ ) {
+      x1 = 2 * x + 1 < XRES ? 2 * x + 1 : 2 * x;
+      r[x] = (CHANNEL(s[2*row][2*x].red) + CHANNEL(s[2*row][x1].red) +
+	      CHANNEL(s[row1][2*x].red) + CHANNEL(s[row1][x1].red) + 2) >> 2;
+      g[x] = (CHANNEL(s[2*row][2*x].green) + CHANNEL(s[2*row][x1].green) +
+	      CHANNEL(s[row1][2*x].green) + CHANNEL(s[row1][x1].green) + 2) >> 2;
+      b[x] = (CHANNEL(s[2*row][2*x].blue) + CHANNEL(s[2*row][x1].blue) +
+	      CHANNEL(s[row1][2*x].blue) + CHANNEL(s[row1][x1].blue) + 2) >> 2;
+    }
+    chroma(r, g, b, up + row * CHROMA_XRES, vp + row * CHROMA_XRES, CHROMA_XRES);
+  }
+
+  if ( fputs("FRAME\n", y->f) == EOF ||
+       fwrite(y->frame, 1, y->frame_size, y->f) != y->frame_size ||
+       fflush(y->f) == EOF ) {
+    printf("Error: could not write video frame\n");
+    return -1;
+  }
+  return 0;
+}
+
+/*======== void close_y4m() ==========
+Inputs:   struct y4m_stream *y
+Returns:
+
+Closes the stream and frees y
+====================*/
+void close_y4m( struct y4m_stream *y ) {
+
+  fclose(y->f);
+  free(y->frame);
+  free(y);
+}
@@ -0,0 +1,128 @@
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include <stdio.h>
+#include <pthread.h>
+
+#include "ml6.h"
+
+/*
+  Asynchronous saving of animation frames. Finished frames are
+  copied into one of a fixed number of buffers and saved by
+  encoder threads while the next frame is drawn. When every
+  buffer is waiting to be saved, queue_frame blocks until one
+  is free, so drawing never runs more than OUTPUT_FRAMES_PER_THREAD
+  frames per encoder ahead of saving.
+*/
+//most encoder threads started, whatever the number of cpus
+#define OUTPUT_MAX_THREADS 4
+//frame buffers per encoder thread
+#define OUTPUT_FRAMES_PER_THREAD 2
+
+/*
+  A journal of the frames of an animation that have been saved,
+  for picking a run back up where it stopped. It is a text file
+  starting with a line
+
+    MDLJ <scene hash> <number of frames>
+
+  followed by the number of each frame once its file is
+  completely written.
+*/
+#define JOURNAL_MAGIC "MDLJ"
+
+struct journal {
+  FILE *f;
+  char *done;     /* done[f] is set once frame f is saved */
+  int num_frames;
+  pthread_mutex_t lock;
+};
+
+struct output_queue {
+  pthread_t *threads;
+  int num_threads;
+
+  //num_buffers copies of the screen and the file each is saved to
+  color (*buffers)[YRES][XRES];
+  char (*files)[256];
+  int *frames;
+  int num_buffers;
+  struct journal *journal; /* frames saved are recorded here, if set */
+
+  //indices of buffers waiting to be saved (in order) and free
+  int *ready;
+  int ready_head, num_ready;
+  int *free;
+  int num_free;
+  int done;
+  int failed; /* frames save_extension failed on */
+
+  pthread_mutex_t lock;
+  pthread_cond_t frame_ready;
+  pthread_cond_t buffer_free;
+};
+
+struct journal * open_journal( char *file, unsigned long hash, int num_frames );
+int frame_done( struct journal *j, int frame );
+void record_frame( struct journal *j, int frame );
+void close_journal( struct journal *j );
+
+struct output_queue * start_output( struct journal *journal );
+void queue_frame( struct output_queue *q, screen s, char *file, int frame );
+int finish_output( struct output_queue *q );
+
+/*
+  Raw frame files hold a raw_header followed by num_frames
+  frames of height rows of width RGB pixels, one byte per
+  channel, top row first. They start at frame first_frame of
+  the animation, which is 0 unless only some frames were drawn. The file is sized for every frame up
+  front and memory mapped, so each frame is written straight
+  from the screen into place and readers can map it the same
+  way.
+*/
+#define RAW_MAGIC "MDLR"
+#define RAW_VERSION 1
+
+struct raw_header {
+  char magic[4];
+  int version;
+  int width;
+  int height;
+  int num_frames;
+  int channels;
+  int first_frame;
+  int reserved;
+};
+
+struct raw_frames {
+  unsigned char *map;
+  size_t size;
+  int num_frames;
+};
+
+struct raw_frames * open_raw_frames( char *file, int first_frame, int num_frames );
+void write_raw_frame( struct raw_frames *r, int frame, screen s );
+void close_raw_frames( struct raw_frames *r );
+
+/*
+  YUV4MPEG2 streams, as read by video encoders: a header line,
+  then for each frame a FRAME line followed by its Y plane and
+  its U and V planes at half resolution in each direction
+  (4:2:0, full range BT.601, declared with XCOLORRANGE=FULL).
+*/
+//the same 3/100s per frame make_animation uses
+#define Y4M_RATE "100:3"
+#define CHROMA_XRES ((XRES + 1) / 2)
+#define CHROMA_YRES ((YRES + 1) / 2)
+
+struct y4m_stream {
+  FILE *f;
+  unsigned char *frame; /* Y, U and V planes of one frame */
+  size_t frame_size;
+};
+
+struct y4m_stream * open_y4m( char *file, int fd );
+int write_y4m_frame( struct y4m_stream *y, screen s );
+void close_y4m( struct y4m_stream *y );
+
+#endif
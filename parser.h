@@ -4,7 +4,7 @@
 #include "symtab.h"
 #include "matrix.h"
 
-#define MAX_COMMANDS 512
+struct mesh;
 
 extern int lastop;
 
@@ -71,23 +71,28 @@ struct command
       SYMTAB *constants;
       char name[255];
       SYMTAB *cs; 
+      struct mesh *data; /* filled in by load_resources */
     } mesh;
     struct {
       SYMTAB *p;
       double val;
+      int knob; /* slot in knob_values, -1 for none */
     } set;
     struct {
       double d[4];
       SYMTAB *p;
+      int knob;
     } move;
     struct {
       double d[4];
       SYMTAB *p;
+      int knob;
     } scale;
     struct {
       double axis;
       double degrees;
       SYMTAB *p;
+      int knob;
     } rotate;
     struct {
       SYMTAB *p;
@@ -106,6 +111,7 @@ struct command
     struct {
       SYMTAB *p;
       double start_frame, end_frame, start_val, end_val;
+      int knob;
     } vary;
     struct {
       SYMTAB *p;
@@ -124,26 +130,60 @@ struct command
 
 
 
-extern struct command op[MAX_COMMANDS];
+//grows as the script is parsed, lastop commands long
+extern struct command *op;
 
 //Code generator headers
 int num_frames;
 char name[128];
 
-struct vary_node {
-  
-  char name[128];
-  double value;
-  struct vary_node *next;
+//settings from the command line, see main in mdl.y
+struct options {
+  char *raw_file;  /* write frames to this raw frame file */
+  char *y4m_file;  /* stream frames as YUV4MPEG2 to this file */
+  int y4m_fd;      /* or to this descriptor (for stdout), -1 if not */
+  char *shm_name;  /* publish images to this shared memory object */
+  int preview;     /* draw still images progressively */
+  int serve;       /* keep the scene resident and take commands */
+  char *socket_path; /* from this UNIX socket, or else stdin */
+  int reply_fd;    /* replies to stdin's commands go here */
+  char *batch_file; /* draw the images listed here and exit */
+  int first_frame; /* draw only these frames, -1 for all */
+  int last_frame;
+  int shard;       /* or only shard's share of num_shards (0 if not) */
+  int num_shards;
+  int merge;       /* only make the animation from saved frames */
+  int resume;      /* skip frames an earlier run already saved */
+  char *script_file;
+};
+extern struct options options;
+
+/*
+  Knob values for the whole animation: num_frames rows of
+  num_knobs values, one column per knob slot, so frame f's
+  knobs are values + f * num_knobs.
+*/
+struct knob_table {
+  int num_frames;
+  int num_knobs;
+  double *values;
 };
 
 void print_knobs();
 void process_knobs();
 void first_pass();
-struct vary_node ** second_pass();
+struct knob_table * second_pass();
+void free_knob_table( struct knob_table *t );
+char * animated_knobs( struct knob_table *t );
+int frame_range( int *first, int *last );
+void frame_file_name( char *file, int f );
+int merge_frames();
+unsigned long scene_hash();
+void load_resources();
+void free_resources();
 
 void print_pcode();
-void my_main();
+int my_main();
 #endif
 
 
@@ -116,7 +116,7 @@ void print_pcode()
 	case SET:
 	  printf("Set: %s %6.2f",
 		 op[i].op.set.p->name,
-		 op[i].op.set.p->s.value);
+		 op[i].op.set.val);
 	  break;
 	case MOVE:
 	  printf("Move: %6.2f %6.2f %6.2f",
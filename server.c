@@ -0,0 +1,496 @@
+/*====================== server.c ========================
+Server and batch modes, for drawing many images of one scene.
+
+The script is parsed, its meshes loaded and its ops compiled
+once, then the scene stays in memory and is drawn on request,
+so each image costs only the drawing. Commands are read a line
+at a time from stdin (-i) or from clients of a UNIX domain
+socket (-u), and each gets a one line reply, "ok" or
+"error: " and a reason:
+
+  set knob value   set one knob
+  setknobs value   set every knob
+  frame n          set the knobs to those of frame n
+  render [n]       draw with the current knobs (or frame n's)
+  save file        save the last image drawn
+  display          display the last image drawn
+  quit             end the session (or connection)
+  shutdown         stop the server
+
+Batch mode (-b) instead draws one image per line of a file
+naming the image and the knobs to set for it, e.g.
+
+  ring_small.png size 0.5 spin 10
+  ring_big.png size 2
+
+spread over one worker process per cpu. The workers are forked
+once everything is loaded, so they share the scene.
+
+With -p, render only starts drawing, on a thread of its own,
+and replies straight away. Each coarse preview and then the
+finished image are published to the shared memory display
+(-s). save, display and quit wait for the drawing to finish,
+while set, setknobs, frame, render and shutdown abandon it
+first, so a client changing the knobs never waits for an
+image it no longer wants.
+
+In both, the knobs start out as the script leaves them (frame
+0's, in an animation) and the script's own save and display
+commands aren't run.
+==================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <signal.h>
+#include <pthread.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "parser.h"
+#include "symtab.h"
+#include "ml6.h"
+#include "display.h"
+#include "bytecode.h"
+#include "server.h"
+
+/*======== void * render_worker() ==========
+Inputs:   void *arg
+Returns: NULL
+
+Thread drawing the scene of the struct server arg
+progressively, publishing the finished image as sv->frame
+unless it is cancelled first
+====================*/
+static void * render_worker( void *arg ) {
+
+  struct server *sv = (struct server *)arg;
+
+  if ( run_progressive(sv->prog, sv->s, sv->zb) == 0 )
+    publish_screen(sv->s, sv->frame);
+  else
+    sv->frame = -1;
+  return NULL;
+}
+
+/*======== void finish_render() ==========
+Inputs:   struct server *sv
+          int cancel
+Returns:
+
+Waits for a render on sv's worker thread to end, cancelling it
+first if cancel is set. Does nothing if none is running.
+====================*/
+static void finish_render( struct server *sv, int cancel ) {
+
+  if ( !sv->rendering )
+    return;
+  if ( cancel )
+    sv->prog->cancel = 1;
+  pthread_join(sv->worker, NULL);
+  sv->prog->cancel = 0;
+  sv->rendering = 0;
+}
+
+/*======== int serve_command() ==========
+Inputs:   struct server *sv
+          char *line
+          FILE *out
+Returns: SERVE_CONTINUE, or SERVE_QUIT or SERVE_SHUTDOWN when
+         the command ends the session or the server
+
+Runs the command in line against sv and writes its reply to
+out. Blank lines and lines starting with // are ignored.
+====================*/
+int serve_command( struct server *sv, char *line, FILE *out ) {
+
+  char command[32], arg[256];
+  double value;
+  int n, frame, j;
+  SYMTAB *p;
+
+  n = sscanf(line, "%31s %255s %lf", command, arg, &value);
+  if ( n < 1 || !strncmp(command, "//", 2) )
+    return SERVE_CONTINUE;
+
+  if ( !strcmp(command, "set") ) {
+    if ( n < 3 ) {
+      fprintf(out, "error: usage: set knob value\n");
+      return SERVE_CONTINUE;
+    }
+    p = lookup_symbol(arg);
+    if ( p == NULL || p->type != SYM_VALUE ) {
+      fprintf(out, "error: no knob %s\n", arg);
+      return SERVE_CONTINUE;
+    }
+    finish_render(sv, 1);
+    set_knob(knob_slot(p), value);
+  }
+
+  else if ( !strcmp(command, "setknobs") ) {
+    if ( n < 2 || sscanf(arg, "%lf", &value) != 1 ) {
+      fprintf(out, "error: usage: setknobs value\n");
+      return SERVE_CONTINUE;
+    }
+    finish_render(sv, 1);
+    for ( j=0; j < num_knobs; j++ )
+      set_knob(j, value);
+  }
+
+  else if ( !strcmp(command, "frame") || !strcmp(command, "render") ) {
+    frame = sv->frame < 0 ? 0 : sv->frame;
+    if ( n >= 2 ) {
+      if ( sscanf(arg, "%d", &frame) != 1 ||
+	   frame < 0 || frame >= sv->knobs->num_frames ) {
+	fprintf(out, "error: frames are 0 to %d\n", sv->knobs->num_frames - 1);
+	return SERVE_CONTINUE;
+      }
+    }
+    finish_render(sv, 1);
+    if ( n >= 2 )
+      set_knobs(sv->knobs->values + (size_t)frame * sv->knobs->num_knobs);
+    if ( !strcmp(command, "render") ) {
+      sv->frame = frame;
+      if ( options.preview &&
+	   !pthread_create(&sv->worker, NULL, render_worker, sv) )
+	sv->rendering = 1;
+      else {
+	clear_screen(sv->s);
+	clear_zbuffer(sv->zb);
+	run_program(sv->prog, sv->s, sv->zb);
+	publish_screen(sv->s, frame);
+      }
+    }
+  }
+
+  else if ( !strcmp(command, "save") ) {
+    if ( n < 2 ) {
+      fprintf(out, "error: usage: save file\n");
+      return SERVE_CONTINUE;
+    }
+    finish_render(sv, 0);
+    if ( sv->frame < 0 ) {
+      fprintf(out, "error: nothing rendered yet\n");
+      return SERVE_CONTINUE;
+    }
+    if ( save_extension(sv->s, arg) ) {
+      fprintf(out, "error: could not save %s\n", arg);
+      return SERVE_CONTINUE;
+    }
+  }
+
+  else if ( !strcmp(command, "display") ) {
+    finish_render(sv, 0);
+    display(sv->s);
+  }
+
+  else if ( !strcmp(command, "quit") ) {
+    finish_render(sv, 0);
+    fprintf(out, "ok\n");
+    return SERVE_QUIT;
+  }
+  else if ( !strcmp(command, "shutdown") ) {
+    finish_render(sv, 1);
+    fprintf(out, "ok\n");
+    return SERVE_SHUTDOWN;
+  }
+
+  else {
+    fprintf(out, "error: unknown command %s\n", command);
+    return SERVE_CONTINUE;
+  }
+
+  fprintf(out, "ok\n");
+  return SERVE_CONTINUE;
+}
+
+/*======== int serve_stream() ==========
+Inputs:   struct server *sv
+          FILE *in
+          FILE *out
+Returns: SERVE_SHUTDOWN if the session ended with shutdown
+
+Runs commands read from in, replying on out, until the end
+of in or a command that ends the session
+====================*/
+int serve_stream( struct server *sv, FILE *in, FILE *out ) {
+
+  char line[SERVER_LINE];
+  int r = SERVE_CONTINUE;
+
+  while ( r == SERVE_CONTINUE && fgets(line, sizeof(line), in) ) {
+    r = serve_command(sv, line, out);
+    fflush(out);
+  }
+  return r;
+}
+
+/*======== int serve_socket() ==========
+Inputs:   struct server *sv
+          char *path
+Returns: 0 once shut down, -1 if the socket can't be opened
+
+Listens on a UNIX domain socket at path (replacing any old
+one) and serves its clients one connection at a time, until
+one of them sends shutdown.
+====================*/
+int serve_socket( struct server *sv, char *path ) {
+
+  struct sockaddr_un addr;
+  int fd, client, r = SERVE_CONTINUE;
+  FILE *in, *out;
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if ( strlen(path) >= sizeof(addr.sun_path) ) {
+    printf("Error: socket path %s is too long\n", path);
+    return -1;
+  }
+  strcpy(addr.sun_path, path);
+
+  fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  unlink(path);
+  if ( fd < 0 || bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+       listen(fd, SERVER_BACKLOG) < 0 ) {
+    printf("Error: could not listen on %s\n", path);
+    if ( fd >= 0 )
+      close(fd);
+    return -1;
+  }
+  printf("Serving on %s\n", path);
+  fflush(stdout);
+
+  while ( r != SERVE_SHUTDOWN && (client = accept(fd, NULL, NULL)) >= 0 ) {
+    in = fdopen(client, "r");
+    out = fdopen(dup(client), "w");
+    r = serve_stream(sv, in, out);
+    fclose(in);
+    fclose(out);
+  }
+
+  close(fd);
+  unlink(path);
+  return 0;
+}
+
+/*======== void serve() ==========
+Inputs:   struct program *prog
+          struct knob_table *knobs
+          screen s
+          zbuffer zb
+Returns:
+
+Serves the scene in prog on the socket given with -u, or else
+on stdin, replying on options.reply_fd (the real stdout)
+====================*/
+void serve( struct program *prog, struct knob_table *knobs,
+	    screen s, zbuffer zb ) {
+
+  struct server sv;
+  FILE *out;
+
+  sv.prog = prog;
+  sv.knobs = knobs;
+  sv.s = s;
+  sv.zb = zb;
+  sv.frame = -1;
+  sv.rendering = 0;
+  prog->skip_output = 1;
+  prog->cancel = 0;
+  set_knobs(knobs->values);
+  //neither a client hanging up nor a convert failing may take
+  //the server down with it
+  signal(SIGPIPE, SIG_IGN);
+
+  if ( options.socket_path )
+    serve_socket(&sv, options.socket_path);
+  else {
+    out = fdopen(options.reply_fd, "w");
+    serve_stream(&sv, stdin, out);
+    fclose(out);
+  }
+  finish_render(&sv, 1);
+}
+
+/*======== int read_batch() ==========
+Inputs:   char *file
+          struct batch_job **jobs
+          int *rejected
+Returns: The number of images listed in file, which are stored
+         in *jobs, or -1 if file can't be read
+
+Each line holds the file to save an image to and then any
+number of knob name and value pairs. Blank lines and lines
+starting with // are skipped. Lines naming a knob the script
+doesn't have, or a knob without a value, are skipped with an
+error and counted in *rejected.
+====================*/
+static int read_batch( char *file, struct batch_job **jobs, int *rejected ) {
+
+  FILE *f;
+  char line[SERVER_LINE], name[256];
+  char *p;
+  int lineno = 0, size = 0, n = 0, used, ok;
+  double value;
+  SYMTAB *sym;
+  struct batch_job *job;
+
+  f = fopen(file, "r");
+  if ( f == NULL ) {
+    printf("Error: could not open batch file %s\n", file);
+    return -1;
+  }
+  *jobs = NULL;
+  *rejected = 0;
+
+  while ( fgets(line, sizeof(line), f) ) {
+    lineno++;
+    if ( sscanf(line, "%255s%n", name, &used) < 1 || !strncmp(name, "//", 2) )
+      continue;
+    if ( n == size ) {
+      size = size ? size * 2 : 64;
+      *jobs = (struct batch_job *)realloc(*jobs, size * sizeof(struct batch_job));
+    }
+    job = *jobs + n;
+    strcpy(job->file, name);
+    job->num_knobs = 0;
+    job->knobs = (int *)malloc(num_knobs * sizeof(int));
+    job->values = (double *)malloc(num_knobs * sizeof(double));
+
+    ok = 1;
+    p = line + used;
+    while ( ok && sscanf(p, "%255s %lf%n", name, &value, &used) == 2 ) {
+      p+= used;
+      sym = lookup_symbol(name);
+      if ( sym == NULL || sym->type != SYM_VALUE ) {
+	printf("Error: %s line %d: no knob %s\n", file, lineno, name);
+	ok = 0;
+      }
+      else if ( job->num_knobs < num_knobs ) {
+	job->knobs[job->num_knobs] = knob_slot(sym);
+	job->values[job->num_knobs++] = value;
+      }
+    }
+    //anything left over is a knob without a usable value
+    if ( ok && sscanf(p, "%255s", name) == 1 ) {
+      printf("Error: %s line %d: no value for knob %s\n", file, lineno, name);
+      ok = 0;
+    }
+    if ( ok )
+      n++;
+    else {
+      (*rejected)++;
+      free(job->knobs);
+      free(job->values);
+    }
+  }
+  fclose(f);
+  return n;
+}
+
+/*======== int draw_job() ==========
+Inputs:   struct server *sv
+          struct batch_job *job
+Returns: 0 if the image was saved, -1 otherwise
+
+Draws the scene with job's knobs set and saves it
+====================*/
+static int draw_job( struct server *sv, struct batch_job *job ) {
+
+  int i;
+
+  set_knobs(sv->knobs->values);
+  for ( i=0; i < job->num_knobs; i++ )
+    set_knob(job->knobs[i], job->values[i]);
+  clear_screen(sv->s);
+  clear_zbuffer(sv->zb);
+  run_program(sv->prog, sv->s, sv->zb);
+  if ( save_extension(sv->s, job->file) ) {
+    printf("Error: could not save %s\n", job->file);
+    fflush(stdout);
+    return -1;
+  }
+  printf("Saved %s\n", job->file);
+  fflush(stdout);
+  return 0;
+}
+
+/*======== int run_batch() ==========
+Inputs:   struct program *prog
+          struct knob_table *knobs
+          screen s
+          zbuffer zb
+          char *file
+Returns: 0 if every image in the batch file file was drawn and
+         saved, -1 otherwise
+
+Worker w of n draws images w, w + n, w + 2n... in a process
+of its own, one per cpu, or all of them in this one when
+there is a single cpu or image.
+====================*/
+int run_batch( struct program *prog, struct knob_table *knobs,
+	       screen s, zbuffer zb, char *file ) {
+
+  struct server sv;
+  struct batch_job *jobs;
+  int num_jobs, rejected, i, w, workers, status, failed;
+  long cpus;
+  pid_t pid;
+
+  num_jobs = read_batch(file, &jobs, &rejected);
+  if ( num_jobs < 0 )
+    return -1;
+  //lines that were rejected are images that won't be drawn
+  failed = rejected > 0;
+
+  sv.prog = prog;
+  sv.knobs = knobs;
+  sv.s = s;
+  sv.zb = zb;
+  sv.frame = -1;
+  sv.rendering = 0;
+  prog->skip_output = 1;
+  //a convert that fails mustn't take the batch down with it,
+  //just that image
+  signal(SIGPIPE, SIG_IGN);
+
+  cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  workers = cpus < 1 ? 1 : cpus > num_jobs ? num_jobs : (int)cpus;
+  if ( workers <= 1 ) {
+    for ( i=0; i < num_jobs; i++ )
+      if ( draw_job(&sv, jobs + i) )
+	failed = 1;
+  }
+  else {
+    //nothing buffered may be printed twice
+    fflush(stdout);
+    for ( w=0; w < workers; w++ ) {
+      pid = fork();
+      if ( pid == 0 ) {
+	status = 0;
+	for ( i=w; i < num_jobs; i+= workers )
+	  if ( draw_job(&sv, jobs + i) )
+	    status = 1;
+	_exit(status);
+      }
+      if ( pid < 0 ) {
+	printf("Error: could not start batch worker, drawing its images here\n");
+	for ( i=w; i < num_jobs; i+= workers )
+	  if ( draw_job(&sv, jobs + i) )
+	    failed = 1;
+      }
+    }
+    while ( wait(&status) > 0 )
+      if ( !WIFEXITED(status) || WEXITSTATUS(status) )
+	failed = 1;
+  }
+
+  for ( i=0; i < num_jobs; i++ ) {
+    free(jobs[i].knobs);
+    free(jobs[i].values);
+  }
+  free(jobs);
+  return failed ? -1 : 0;
+}
@@ -0,0 +1,55 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <stdio.h>
+#include <pthread.h>
+
+#include "ml6.h"
+#include "parser.h"
+#include "bytecode.h"
+
+//longest command line read
+#define SERVER_LINE 1024
+//pending connections on the socket
+#define SERVER_BACKLOG 8
+
+//what serve_command tells its caller to do next
+#define SERVE_CONTINUE 0
+#define SERVE_QUIT 1
+#define SERVE_SHUTDOWN 2
+
+/*
+  The resident scene: its compiled program, knob table and the
+  screen and zbuffer images are drawn into, kept between
+  commands. With -p renders are drawn progressively on worker,
+  while rendering is set.
+*/
+struct server {
+  struct program *prog;
+  struct knob_table *knobs;
+  color (*s)[XRES];
+  double (*zb)[XRES];
+  int frame; /* frame of the last render, -1 before any or if cancelled */
+  pthread_t worker;
+  int rendering;
+};
+
+/*
+  One image of a batch: the knobs to set and where to save it
+*/
+struct batch_job {
+  char file[256];
+  int num_knobs;
+  int *knobs;
+  double *values;
+};
+
+int serve_command( struct server *sv, char *line, FILE *out );
+int serve_stream( struct server *sv, FILE *in, FILE *out );
+int serve_socket( struct server *sv, char *path );
+void serve( struct program *prog, struct knob_table *knobs,
+	    screen s, zbuffer zb );
+int run_batch( struct program *prog, struct knob_table *knobs,
+	       screen s, zbuffer zb, char *file );
+
+#endif
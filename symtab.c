@@ -6,8 +6,26 @@
 #include "symtab.h"
 #include "matrix.h"
 
-SYMTAB symtab[MAX_SYMBOLS];
+/*
+  The symbols, lastsym of them, in blocks of SYMTAB_BLOCK.
+  Ops point straight at symbols, so they are never moved once
+  added; only the array of blocks grows.
+*/
+SYMTAB **symtab = NULL;
 int lastsym = 0;
+static int max_blocks = 0;
+
+//current value of every knob (SYM_VALUE symbol), by slot
+double *knob_values = NULL;
+int num_knobs = 0;
+static int max_knobs = 0;
+
+/*
+  Open addressing hash index over symtab: each bucket holds a
+  symtab index + 1, or 0 if empty. It is kept at most half full.
+*/
+static int *sym_index = NULL;
+static int index_size = 0;
 
 
 void print_constants(struct constants *p)
@@ -41,33 +59,110 @@ void print_symtab()
   int i;
   for (i=0; i < lastsym;i++)
     {
-      printf("Name: %s\n",symtab[i].name);
-      switch (symtab[i].type)
+      printf("Name: %s\n",symbol_at(i)->name);
+      switch (symbol_at(i)->type)
 	{
 	case SYM_MATRIX:
 	  printf("Type: SYM_MATRIX\n");
-	  print_matrix(symtab[i].s.m);
+	  print_matrix(&symbol_at(i)->s.cs->view);
 	  break;
 	case SYM_CONSTANTS:
 	  printf("Type: SYM_CONSTANTS\n");
-	  print_constants(symtab[i].s.c);
+	  print_constants(symbol_at(i)->s.c);
 	  break;
 	case SYM_LIGHT:
 	  printf("Type: SYM_LIGHT\n");
-	  print_light(symtab[i].s.l);
+	  print_light(symbol_at(i)->s.l);
 	  break;
 	case SYM_VALUE:
 	  printf("Type: SYM_VALUE\n");
-	  printf("value: %6.2f\n", symtab[i].s.value);
+	  printf("value: %6.2f\n", get_value(symbol_at(i)));
+	  break;
+	case SYM_KNOBLIST:
+	  printf("Type: SYM_KNOBLIST\n");
 	  break;
 	case SYM_FILE:
 	  printf("Type: SYM_VALUE\n");
-	  printf("Name: %s\n",symtab[i].name);
+	  printf("Name: %s\n",symbol_at(i)->name);
 	}
       printf("\n");
     }
 }
 
+/*======== unsigned int hash_name() ==========
+Inputs:   char *name
+Returns: The FNV-1a hash of name
+====================*/
+static unsigned int hash_name(char *name)
+{
+  unsigned int h = 2166136261u;
+
+  while (*name)
+    h = (h ^ (unsigned char)*name++) * 16777619u;
+  return h;
+}
+
+/*======== int *find_bucket() ==========
+Inputs:   char *name
+Returns: The bucket of sym_index holding name, or the empty
+         bucket where it would go
+====================*/
+static int *find_bucket(char *name)
+{
+  unsigned int i = hash_name(name) & (index_size - 1);
+
+  while (sym_index[i] && strcmp(name, symbol_at(sym_index[i] - 1)->name))
+    i = (i + 1) & (index_size - 1);
+  return &sym_index[i];
+}
+
+/*======== void grow_index() ==========
+Inputs:
+Returns:
+
+Doubles the size of sym_index and rehashes every symbol into it
+====================*/
+static void grow_index()
+{
+  int i;
+
+  free(sym_index);
+  index_size = index_size ? index_size * 2 : 64;
+  sym_index = (int *)calloc(index_size, sizeof(int));
+  for (i=0; i < lastsym; i++)
+    *find_bucket(symbol_at(i)->name) = i + 1;
+}
+
+/*======== void add_block() ==========
+Inputs:
+Returns:
+
+Adds room for another SYMTAB_BLOCK symbols
+====================*/
+static void add_block()
+{
+  int b = lastsym / SYMTAB_BLOCK;
+
+  if (b == max_blocks)
+    {
+      max_blocks = max_blocks ? max_blocks * 2 : 8;
+      symtab = (SYMTAB **)realloc(symtab, max_blocks * sizeof(SYMTAB *));
+    }
+  symtab[b] = (SYMTAB *)calloc(SYMTAB_BLOCK, sizeof(SYMTAB));
+}
+
+SYMTAB *lookup_symbol(char *name)
+{
+  int *bucket;
+
+  if (index_size == 0)
+    return (SYMTAB *)NULL;
+  bucket = find_bucket(name);
+  if (*bucket == 0)
+    return (SYMTAB *)NULL;
+  return symbol_at(*bucket - 1);
+}
+
 SYMTAB *add_symbol(char *name, int type, void *data)
 {
   SYMTAB *t;
@@ -75,11 +170,11 @@ SYMTAB *add_symbol(char *name, int type, void *data)
   t = (SYMTAB *)lookup_symbol(name);
   if (t==NULL)
     {
-      if (lastsym >= MAX_SYMBOLS)
-	{
-	  return NULL;
-	}
-      t = (SYMTAB *)&(symtab[lastsym]);
+      if (lastsym % SYMTAB_BLOCK == 0)
+	add_block();
+      if ((lastsym + 1) * 2 > index_size)
+	grow_index();
+      t = symbol_at(lastsym);
       lastsym++;
     }
   else
@@ -90,43 +185,133 @@ SYMTAB *add_symbol(char *name, int type, void *data)
   t->name = (char *)malloc(strlen(name)+1);
   strcpy(t->name,name);
   t->type = type;
+  *find_bucket(name) = lastsym;
   switch (type)
     {
     case SYM_CONSTANTS:
       t->s.c = (struct constants *)data;
       break;
     case SYM_MATRIX:
-      t->s.m = (struct matrix *)data;
+      t->s.cs = new_coord_system();
       break;
     case SYM_LIGHT:
       t->s.l = (struct light *)data;
       break;
     case SYM_VALUE:
-      t->s.value = (double)(int)data;
+      t->s.knob = add_knob((double)(long)data);
+      break;
+    case SYM_KNOBLIST:
+      t->s.knobs = NULL;
       break;
     case SYM_FILE:
       break;
     }
-  return (SYMTAB *)&(symtab[lastsym-1]);
+  return t;
 }
 
 
-SYMTAB *lookup_symbol(char *name)
+void set_value(SYMTAB *p, double value)
 {
-  int i;
-  for (i=0;i<lastsym;i++)
+  set_knob(knob_slot(p), value);
+}
+
+/*======== int knob_slot() ==========
+Inputs:   SYMTAB *p
+Returns: The slot of knob p in knob_values, or -1 if p isn't
+         a knob
+
+Ops keep this instead of the symbol, so the frame loop goes
+straight to the value.
+====================*/
+int knob_slot(SYMTAB *p)
+{
+  if (p == NULL || p->type != SYM_VALUE)
+    return -1;
+  return p->s.knob;
+}
+
+void set_knob(int knob, double value)
+{
+  if (knob < 0)
+    return;
+  knob_values[knob] = value;
+}
+
+double get_value(SYMTAB *p)
+{
+  return knob_values[p->s.knob];
+}
+
+/*======== int add_knob() ==========
+Inputs:   double value
+Returns: The slot of a new knob starting at value
+
+knob_values grows as needed, so it should only be held on to
+once parsing is done
+====================*/
+int add_knob(double value)
+{
+  if (num_knobs == max_knobs)
     {
-      if (!strcmp(name,symtab[i].name))
-	{
-	  return (SYMTAB *) &(symtab[i]);
-	}
+      max_knobs = max_knobs ? max_knobs * 2 : 64;
+      knob_values = (double *)realloc(knob_values, max_knobs * sizeof(double));
     }
-  return (SYMTAB *)NULL;
+  knob_values[num_knobs] = value;
+  return num_knobs++;
 }
 
-void set_value(SYMTAB *p, double value)
+/*======== void set_knobs() ==========
+Inputs:   double *values
+Returns:
+
+Sets every knob at once from values, which holds one value per
+knob slot
+====================*/
+void set_knobs(double *values)
+{
+  memcpy(knob_values, values, num_knobs * sizeof(double));
+}
+
+/*======== struct coord_system * new_coord_system() ==========
+Inputs:
+Returns: A new coordinate system holding the identity matrix,
+         not saved by any op yet
+====================*/
+struct coord_system *new_coord_system()
 {
-  p->s.value = value;
+  struct coord_system *cs;
+  int r;
+
+  cs = (struct coord_system *)calloc(1, sizeof(struct coord_system));
+  for (r=0; r < 4; r++)
+    {
+      cs->m[r][r] = 1;
+      cs->rows[r] = cs->m[r];
+    }
+  cs->view.m = cs->rows;
+  cs->view.rows = 4;
+  cs->view.cols = 4;
+  cs->view.lastcol = 4;
+  cs->source = -1;
+  return cs;
+}
+
+/*======== void save_coord_system() ==========
+Inputs:   struct coord_system *cs
+          struct matrix *m
+          int source
+Returns:
+
+Copies the 4x4 matrix m into cs and stamps it with the
+instruction saving it
+====================*/
+void save_coord_system(struct coord_system *cs, struct matrix *m, int source)
+{
+  int r;
+
+  for (r=0; r < 4; r++)
+    memcpy(cs->m[r], m->m[r], 4 * sizeof(double));
+  cs->source = source;
 }
 
 
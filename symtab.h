@@ -1,13 +1,17 @@
 #ifndef SYMTAB_H
 #define SYMTAB_H
 
-#define MAX_SYMBOLS 512
+#include "matrix.h"
+
+//symbols are stored in blocks of this many, which never move
+#define SYMTAB_BLOCK 256
 #define SYM_MATRIX 1
 #define SYM_VALUE 2
 #define SYM_CONSTANTS 3
 #define SYM_LIGHT 4
 #define SYM_FILE   5
 #define SYM_STRING 5
+#define SYM_KNOBLIST 6
 
 struct constants 
 {
@@ -17,6 +21,20 @@ struct constants
   double red,green,blue;
 };
 
+/*
+  A named coordinate system (save_coord_system). The matrix is
+  kept inline; view wraps it as a struct matrix so it can be
+  handed to the matrix routines without copying. source is the
+  instruction that last saved it (-1 if none has in this run).
+*/
+struct coord_system
+{
+  double m[4][4];
+  double *rows[4];
+  struct matrix view;
+  int source;
+};
+
 struct light
 {
   double l[4];
@@ -28,15 +46,19 @@ typedef struct
   char *name;
   int type;
   union{
-    struct matrix *m;
+    struct coord_system *cs;
     struct constants *c;
     struct light *l;
-    double value;
+    int knob;        /* SYM_VALUE: slot in knob_values */
+    double *knobs;   /* SYM_KNOBLIST: a value for every knob slot */
   } s;
 } SYMTAB;
 
-extern SYMTAB symtab[MAX_SYMBOLS];
+extern SYMTAB **symtab;
+#define symbol_at(i) (&symtab[(i) / SYMTAB_BLOCK][(i) % SYMTAB_BLOCK])
 extern int lastsym;
+extern double *knob_values;
+extern int num_knobs;
 
 SYMTAB *lookup_symbol(char *name);
 SYMTAB *add_symbol(char *name, int type, void *data);
@@ -45,6 +67,13 @@ void print_light(struct light *p);
 void print_symtab();
 SYMTAB *add_symbol(char *name, int type, void *data);
 void set_value(SYMTAB *p, double value);
+double get_value(SYMTAB *p);
+int knob_slot(SYMTAB *p);
+void set_knob(int knob, double value);
+int add_knob(double value);
+void set_knobs(double *values);
+struct coord_system *new_coord_system();
+void save_coord_system(struct coord_system *cs, struct matrix *m, int source);
 
 
 #endif
@@ -1,14 +1,14 @@
-/* A Bison parser, made by GNU Bison 2.3.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
-/* Skeleton implementation for Bison's Yacc-like parsers in C
+/* Bison implementation for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989, 1990, 2000, 2001, 2002, 2003, 2004, 2005, 2006
-   Free Software Foundation, Inc.
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
 
-   This program is free software; you can redistribute it and/or modify
+   This program is free software: you can redistribute it and/or modify
    it under the terms of the GNU General Public License as published by
-   the Free Software Foundation; either version 2, or (at your option)
-   any later version.
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
 
    This program is distributed in the hope that it will be useful,
    but WITHOUT ANY WARRANTY; without even the implied warranty of
@@ -16,9 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program; if not, write to the Free Software
-   Foundation, Inc., 51 Franklin Street, Fifth Floor,
-   Boston, MA 02110-1301, USA.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -36,6 +34,10 @@
 /* C LALR(1) parser skeleton written by Richard Stallman, by
    simplifying the original so-called "semantic" parser.  */
 
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
 /* All symbols defined below should begin with yy or YY, to avoid
    infringing on user name space.  This should be done even for local
    variables, as they might otherwise be expanded by user macros.
@@ -43,11 +45,11 @@
    define necessary library symbols; they are noted "INFRINGES ON
    USER NAME SPACE" below.  */
 
-/* Identify Bison output.  */
-#define YYBISON 1
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
 
-/* Bison version.  */
-#define YYBISON_VERSION "2.3"
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
 
 /* Skeleton name.  */
 #define YYSKELETON_NAME "yacc.c"
@@ -55,55 +57,129 @@
 /* Pure parsers.  */
 #define YYPURE 0
 
-/* Using locations.  */
-#define YYLSP_NEEDED 0
+/* Push parsers.  */
+#define YYPUSH 0
+
+/* Pull parsers.  */
+#define YYPULL 1
+
+
+
+
+/* First part of user prologue.  */
+#line 1 "mdl.y"
+
+  /* C declarations */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "parser.h"
+#include "matrix.h"
+
+  SYMTAB *s;
+  struct light *l;
+  struct constants *c;
+  struct command *op = NULL;
+  int lastop=0;
+  int max_ops=0;
+  int lineno=0;
+  struct options options;
+#define YYERROR_VERBOSE 1
+
+  int yylex();
+  int yyerror(char *s);
+  void next_op();
+
+  
+
+#line 97 "y.tab.c"
 
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
+#  else
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
+# ifndef YY_NULLPTR
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
+#  else
+#   define YY_NULLPTR ((void*)0)
+#  endif
+# endif
 
+/* Use api.header.include to #include this header
+   instead of duplicating it here.  */
+#ifndef YY_YY_Y_TAB_H_INCLUDED
+# define YY_YY_Y_TAB_H_INCLUDED
+/* Debug traces.  */
+#ifndef YYDEBUG
+# define YYDEBUG 0
+#endif
+#if YYDEBUG
+extern int yydebug;
+#endif
 
-/* Tokens.  */
+/* Token kinds.  */
 #ifndef YYTOKENTYPE
 # define YYTOKENTYPE
-   /* Put the tokens into the symbol table, so that GDB and other debuggers
-      know about them.  */
-   enum yytokentype {
-     COMMENT = 258,
-     DOUBLE = 259,
-     LIGHT = 260,
-     AMBIENT = 261,
-     CONSTANTS = 262,
-     SAVE_COORDS = 263,
-     CAMERA = 264,
-     SPHERE = 265,
-     TORUS = 266,
-     BOX = 267,
-     LINE = 268,
-     CS = 269,
-     MESH = 270,
-     TEXTURE = 271,
-     STRING = 272,
-     SET = 273,
-     MOVE = 274,
-     SCALE = 275,
-     ROTATE = 276,
-     BASENAME = 277,
-     SAVE_KNOBS = 278,
-     TWEEN = 279,
-     FRAMES = 280,
-     VARY = 281,
-     PUSH = 282,
-     POP = 283,
-     SAVE = 284,
-     GENERATE_RAYFILES = 285,
-     SHADING = 286,
-     SHADING_TYPE = 287,
-     SETKNOBS = 288,
-     FOCAL = 289,
-     DISPLAY = 290,
-     WEB = 291,
-     CO = 292
-   };
+  enum yytokentype
+  {
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    COMMENT = 258,                 /* COMMENT  */
+    DOUBLE = 259,                  /* DOUBLE  */
+    LIGHT = 260,                   /* LIGHT  */
+    AMBIENT = 261,                 /* AMBIENT  */
+    CONSTANTS = 262,               /* CONSTANTS  */
+    SAVE_COORDS = 263,             /* SAVE_COORDS  */
+    CAMERA = 264,                  /* CAMERA  */
+    SPHERE = 265,                  /* SPHERE  */
+    TORUS = 266,                   /* TORUS  */
+    BOX = 267,                     /* BOX  */
+    LINE = 268,                    /* LINE  */
+    CS = 269,                      /* CS  */
+    MESH = 270,                    /* MESH  */
+    TEXTURE = 271,                 /* TEXTURE  */
+    STRING = 272,                  /* STRING  */
+    SET = 273,                     /* SET  */
+    MOVE = 274,                    /* MOVE  */
+    SCALE = 275,                   /* SCALE  */
+    ROTATE = 276,                  /* ROTATE  */
+    BASENAME = 277,                /* BASENAME  */
+    SAVE_KNOBS = 278,              /* SAVE_KNOBS  */
+    TWEEN = 279,                   /* TWEEN  */
+    FRAMES = 280,                  /* FRAMES  */
+    VARY = 281,                    /* VARY  */
+    PUSH = 282,                    /* PUSH  */
+    POP = 283,                     /* POP  */
+    SAVE = 284,                    /* SAVE  */
+    GENERATE_RAYFILES = 285,       /* GENERATE_RAYFILES  */
+    SHADING = 286,                 /* SHADING  */
+    SHADING_TYPE = 287,            /* SHADING_TYPE  */
+    SETKNOBS = 288,                /* SETKNOBS  */
+    FOCAL = 289,                   /* FOCAL  */
+    DISPLAY = 290,                 /* DISPLAY  */
+    WEB = 291,                     /* WEB  */
+    CO = 292                       /* CO  */
+  };
+  typedef enum yytokentype yytoken_kind_t;
 #endif
-/* Tokens.  */
+/* Token kinds.  */
+#define YYEMPTY -2
+#define YYEOF 0
+#define YYerror 256
+#define YYUNDEF 257
 #define COMMENT 258
 #define DOUBLE 259
 #define LIGHT 260
@@ -140,101 +216,168 @@
 #define WEB 291
 #define CO 292
 
+/* Value type.  */
+#if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
+union YYSTYPE
+{
+#line 29 "mdl.y"
 
+  double val;
+  char string[255];
 
 
-/* Copy the first part of user declarations.  */
-#line 1 "mdl.y"
-
-  /* C declarations */
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include "parser.h"
-#include "matrix.h"
-
-  SYMTAB *s;
-  struct light *l;
-  struct constants *c;
-  struct command op[MAX_COMMANDS];
-  struct matrix *m;
-  int lastop=0;
-  int lineno=0;
-#define YYERROR_VERBOSE 1
-
-  
+#line 230 "y.tab.c"
 
-/* Enabling traces.  */
-#ifndef YYDEBUG
-# define YYDEBUG 0
+};
+typedef union YYSTYPE YYSTYPE;
+# define YYSTYPE_IS_TRIVIAL 1
+# define YYSTYPE_IS_DECLARED 1
 #endif
 
-/* Enabling verbose error messages.  */
-#ifdef YYERROR_VERBOSE
-# undef YYERROR_VERBOSE
-# define YYERROR_VERBOSE 1
-#else
-# define YYERROR_VERBOSE 0
-#endif
 
-/* Enabling the token table.  */
-#ifndef YYTOKEN_TABLE
-# define YYTOKEN_TABLE 0
-#endif
+extern YYSTYPE yylval;
 
-#if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
-typedef union YYSTYPE
-#line 23 "mdl.y"
-{
-  double val;
-  char string[255];
 
-}
-/* Line 193 of yacc.c.  */
-#line 195 "y.tab.c"
-	YYSTYPE;
-# define yystype YYSTYPE /* obsolescent; will be withdrawn */
-# define YYSTYPE_IS_DECLARED 1
-# define YYSTYPE_IS_TRIVIAL 1
-#endif
+int yyparse (void);
 
 
+#endif /* !YY_YY_Y_TAB_H_INCLUDED  */
+/* Symbol kind.  */
+enum yysymbol_kind_t
+{
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_COMMENT = 3,                    /* COMMENT  */
+  YYSYMBOL_DOUBLE = 4,                     /* DOUBLE  */
+  YYSYMBOL_LIGHT = 5,                      /* LIGHT  */
+  YYSYMBOL_AMBIENT = 6,                    /* AMBIENT  */
+  YYSYMBOL_CONSTANTS = 7,                  /* CONSTANTS  */
+  YYSYMBOL_SAVE_COORDS = 8,                /* SAVE_COORDS  */
+  YYSYMBOL_CAMERA = 9,                     /* CAMERA  */
+  YYSYMBOL_SPHERE = 10,                    /* SPHERE  */
+  YYSYMBOL_TORUS = 11,                     /* TORUS  */
+  YYSYMBOL_BOX = 12,                       /* BOX  */
+  YYSYMBOL_LINE = 13,                      /* LINE  */
+  YYSYMBOL_CS = 14,                        /* CS  */
+  YYSYMBOL_MESH = 15,                      /* MESH  */
+  YYSYMBOL_TEXTURE = 16,                   /* TEXTURE  */
+  YYSYMBOL_STRING = 17,                    /* STRING  */
+  YYSYMBOL_SET = 18,                       /* SET  */
+  YYSYMBOL_MOVE = 19,                      /* MOVE  */
+  YYSYMBOL_SCALE = 20,                     /* SCALE  */
+  YYSYMBOL_ROTATE = 21,                    /* ROTATE  */
+  YYSYMBOL_BASENAME = 22,                  /* BASENAME  */
+  YYSYMBOL_SAVE_KNOBS = 23,                /* SAVE_KNOBS  */
+  YYSYMBOL_TWEEN = 24,                     /* TWEEN  */
+  YYSYMBOL_FRAMES = 25,                    /* FRAMES  */
+  YYSYMBOL_VARY = 26,                      /* VARY  */
+  YYSYMBOL_PUSH = 27,                      /* PUSH  */
+  YYSYMBOL_POP = 28,                       /* POP  */
+  YYSYMBOL_SAVE = 29,                      /* SAVE  */
+  YYSYMBOL_GENERATE_RAYFILES = 30,         /* GENERATE_RAYFILES  */
+  YYSYMBOL_SHADING = 31,                   /* SHADING  */
+  YYSYMBOL_SHADING_TYPE = 32,              /* SHADING_TYPE  */
+  YYSYMBOL_SETKNOBS = 33,                  /* SETKNOBS  */
+  YYSYMBOL_FOCAL = 34,                     /* FOCAL  */
+  YYSYMBOL_DISPLAY = 35,                   /* DISPLAY  */
+  YYSYMBOL_WEB = 36,                       /* WEB  */
+  YYSYMBOL_CO = 37,                        /* CO  */
+  YYSYMBOL_YYACCEPT = 38,                  /* $accept  */
+  YYSYMBOL_input = 39,                     /* input  */
+  YYSYMBOL_command = 40                    /* command  */
+};
+typedef enum yysymbol_kind_t yysymbol_kind_t;
 
-/* Copy the second part of user declarations.  */
 
 
-/* Line 216 of yacc.c.  */
-#line 208 "y.tab.c"
 
 #ifdef short
 # undef short
 #endif
 
-#ifdef YYTYPE_UINT8
-typedef YYTYPE_UINT8 yytype_uint8;
-#else
-typedef unsigned char yytype_uint8;
+/* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
+   <limits.h> and (if available) <stdint.h> are included
+   so that the code can choose integer types of a good width.  */
+
+#ifndef __PTRDIFF_MAX__
+# include <limits.h> /* INFRINGES ON USER NAME SPACE */
+# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
+#  define YY_STDINT_H
+# endif
 #endif
 
-#ifdef YYTYPE_INT8
-typedef YYTYPE_INT8 yytype_int8;
-#elif (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+/* Narrow types that promote to a signed type and that can represent a
+   signed or unsigned integer of at least N bits.  In tables they can
+   save space and decrease cache pressure.  Promoting to a signed type
+   helps avoid bugs in integer arithmetic.  */
+
+#ifdef __INT_LEAST8_MAX__
+typedef __INT_LEAST8_TYPE__ yytype_int8;
+#elif defined YY_STDINT_H
+typedef int_least8_t yytype_int8;
+#else
 typedef signed char yytype_int8;
+#endif
+
+#ifdef __INT_LEAST16_MAX__
+typedef __INT_LEAST16_TYPE__ yytype_int16;
+#elif defined YY_STDINT_H
+typedef int_least16_t yytype_int16;
 #else
-typedef short int yytype_int8;
+typedef short yytype_int16;
 #endif
 
-#ifdef YYTYPE_UINT16
-typedef YYTYPE_UINT16 yytype_uint16;
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
+#endif
+
+#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST8_TYPE__ yytype_uint8;
+#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST8_MAX <= INT_MAX)
+typedef uint_least8_t yytype_uint8;
+#elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
+typedef unsigned char yytype_uint8;
 #else
-typedef unsigned short int yytype_uint16;
+typedef short yytype_uint8;
 #endif
 
-#ifdef YYTYPE_INT16
-typedef YYTYPE_INT16 yytype_int16;
+#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST16_TYPE__ yytype_uint16;
+#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST16_MAX <= INT_MAX)
+typedef uint_least16_t yytype_uint16;
+#elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
+typedef unsigned short yytype_uint16;
 #else
-typedef short int yytype_int16;
+typedef int yytype_uint16;
+#endif
+
+#ifndef YYPTRDIFF_T
+# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
+#  define YYPTRDIFF_T __PTRDIFF_TYPE__
+#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
+# elif defined PTRDIFF_MAX
+#  ifndef ptrdiff_t
+#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  endif
+#  define YYPTRDIFF_T ptrdiff_t
+#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
+# else
+#  define YYPTRDIFF_T long
+#  define YYPTRDIFF_MAXIMUM LONG_MAX
+# endif
 #endif
 
 #ifndef YYSIZE_T
@@ -242,55 +385,106 @@ typedef short int yytype_int16;
 #  define YYSIZE_T __SIZE_TYPE__
 # elif defined size_t
 #  define YYSIZE_T size_t
-# elif ! defined YYSIZE_T && (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
 #  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
 #  define YYSIZE_T size_t
 # else
-#  define YYSIZE_T unsigned int
+#  define YYSIZE_T unsigned
 # endif
 #endif
 
-#define YYSIZE_MAXIMUM ((YYSIZE_T) -1)
+#define YYSIZE_MAXIMUM                                  \
+  YY_CAST (YYPTRDIFF_T,                                 \
+           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
+            ? YYPTRDIFF_MAXIMUM                         \
+            : YY_CAST (YYSIZE_T, -1)))
+
+#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
+
+
+/* Stored state numbers (used for stacks). */
+typedef yytype_uint8 yy_state_t;
+
+/* State numbers in computations.  */
+typedef int yy_state_fast_t;
 
 #ifndef YY_
 # if defined YYENABLE_NLS && YYENABLE_NLS
 #  if ENABLE_NLS
 #   include <libintl.h> /* INFRINGES ON USER NAME SPACE */
-#   define YY_(msgid) dgettext ("bison-runtime", msgid)
+#   define YY_(Msgid) dgettext ("bison-runtime", Msgid)
 #  endif
 # endif
 # ifndef YY_
-#  define YY_(msgid) msgid
+#  define YY_(Msgid) Msgid
+# endif
+#endif
+
+
+#ifndef YY_ATTRIBUTE_PURE
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
+# else
+#  define YY_ATTRIBUTE_PURE
+# endif
+#endif
+
+#ifndef YY_ATTRIBUTE_UNUSED
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
+# else
+#  define YY_ATTRIBUTE_UNUSED
 # endif
 #endif
 
 /* Suppress unused-variable warnings by "using" E.  */
 #if ! defined lint || defined __GNUC__
-# define YYUSE(e) ((void) (e))
+# define YY_USE(E) ((void) (E))
 #else
-# define YYUSE(e) /* empty */
+# define YY_USE(E) /* empty */
 #endif
 
-/* Identity function, used to suppress warnings about constant conditions.  */
-#ifndef lint
-# define YYID(n) (n)
-#else
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static int
-YYID (int i)
+/* Suppress an incorrect diagnostic about yylval being uninitialized.  */
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
+    _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
+    _Pragma ("GCC diagnostic pop")
 #else
-static int
-YYID (i)
-    int i;
+# define YY_INITIAL_VALUE(Value) Value
 #endif
-{
-  return i;
-}
+#ifndef YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END
+#endif
+#ifndef YY_INITIAL_VALUE
+# define YY_INITIAL_VALUE(Value) /* Nothing. */
+#endif
+
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
+#endif
+#ifndef YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
 #endif
 
-#if ! defined yyoverflow || YYERROR_VERBOSE
+
+#define YY_ASSERT(E) ((void) (0 && (E)))
+
+#if !defined yyoverflow
 
 /* The parser invokes alloca or malloc; define the necessary symbols.  */
 
@@ -307,11 +501,11 @@ YYID (i)
 #    define alloca _alloca
 #   else
 #    define YYSTACK_ALLOC alloca
-#    if ! defined _ALLOCA_H && ! defined _STDLIB_H && (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+#    if ! defined _ALLOCA_H && ! defined EXIT_SUCCESS
 #     include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
-#     ifndef _STDLIB_H
-#      define _STDLIB_H 1
+      /* Use EXIT_SUCCESS as a witness for stdlib.h.  */
+#     ifndef EXIT_SUCCESS
+#      define EXIT_SUCCESS 0
 #     endif
 #    endif
 #   endif
@@ -319,8 +513,8 @@ YYID (i)
 # endif
 
 # ifdef YYSTACK_ALLOC
-   /* Pacify GCC's `empty if-body' warning.  */
-#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (YYID (0))
+   /* Pacify GCC's 'empty if-body' warning.  */
+#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (0)
 #  ifndef YYSTACK_ALLOC_MAXIMUM
     /* The OS might guarantee only one guard page at the bottom of the stack,
        and a page size can be as small as 4096 bytes.  So we cannot safely
@@ -334,88 +528,89 @@ YYID (i)
 #  ifndef YYSTACK_ALLOC_MAXIMUM
 #   define YYSTACK_ALLOC_MAXIMUM YYSIZE_MAXIMUM
 #  endif
-#  if (defined __cplusplus && ! defined _STDLIB_H \
+#  if (defined __cplusplus && ! defined EXIT_SUCCESS \
        && ! ((defined YYMALLOC || defined malloc) \
-	     && (defined YYFREE || defined free)))
+             && (defined YYFREE || defined free)))
 #   include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
-#   ifndef _STDLIB_H
-#    define _STDLIB_H 1
+#   ifndef EXIT_SUCCESS
+#    define EXIT_SUCCESS 0
 #   endif
 #  endif
 #  ifndef YYMALLOC
 #   define YYMALLOC malloc
-#   if ! defined malloc && ! defined _STDLIB_H && (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+#   if ! defined malloc && ! defined EXIT_SUCCESS
 void *malloc (YYSIZE_T); /* INFRINGES ON USER NAME SPACE */
 #   endif
 #  endif
 #  ifndef YYFREE
 #   define YYFREE free
-#   if ! defined free && ! defined _STDLIB_H && (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+#   if ! defined free && ! defined EXIT_SUCCESS
 void free (void *); /* INFRINGES ON USER NAME SPACE */
 #   endif
 #  endif
 # endif
-#endif /* ! defined yyoverflow || YYERROR_VERBOSE */
-
+#endif /* !defined yyoverflow */
 
 #if (! defined yyoverflow \
      && (! defined __cplusplus \
-	 || (defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
+         || (defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
 
 /* A type that is properly aligned for any stack member.  */
 union yyalloc
 {
-  yytype_int16 yyss;
-  YYSTYPE yyvs;
-  };
+  yy_state_t yyss_alloc;
+  YYSTYPE yyvs_alloc;
+};
 
 /* The size of the maximum gap between one aligned stack and the next.  */
-# define YYSTACK_GAP_MAXIMUM (sizeof (union yyalloc) - 1)
+# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
 
 /* The size of an array large to enough to hold all stacks, each with
    N elements.  */
 # define YYSTACK_BYTES(N) \
-     ((N) * (sizeof (yytype_int16) + sizeof (YYSTYPE)) \
+     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE)) \
       + YYSTACK_GAP_MAXIMUM)
 
-/* Copy COUNT objects from FROM to TO.  The source and destination do
-   not overlap.  */
-# ifndef YYCOPY
-#  if defined __GNUC__ && 1 < __GNUC__
-#   define YYCOPY(To, From, Count) \
-      __builtin_memcpy (To, From, (Count) * sizeof (*(From)))
-#  else
-#   define YYCOPY(To, From, Count)		\
-      do					\
-	{					\
-	  YYSIZE_T yyi;				\
-	  for (yyi = 0; yyi < (Count); yyi++)	\
-	    (To)[yyi] = (From)[yyi];		\
-	}					\
-      while (YYID (0))
-#  endif
-# endif
+# define YYCOPY_NEEDED 1
 
 /* Relocate STACK from its old location to the new one.  The
    local variables YYSIZE and YYSTACKSIZE give the old and new number of
    elements in the stack, and YYPTR gives the new location of the
    stack.  Advance YYPTR to a properly aligned location for the next
    stack.  */
-# define YYSTACK_RELOCATE(Stack)					\
-    do									\
-      {									\
-	YYSIZE_T yynewbytes;						\
-	YYCOPY (&yyptr->Stack, Stack, yysize);				\
-	Stack = &yyptr->Stack;						\
-	yynewbytes = yystacksize * sizeof (*Stack) + YYSTACK_GAP_MAXIMUM; \
-	yyptr += yynewbytes / sizeof (*yyptr);				\
-      }									\
-    while (YYID (0))
+# define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
+    do                                                                  \
+      {                                                                 \
+        YYPTRDIFF_T yynewbytes;                                         \
+        YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
+        Stack = &yyptr->Stack_alloc;                                    \
+        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
+        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
+      }                                                                 \
+    while (0)
 
 #endif
 
+#if defined YYCOPY_NEEDED && YYCOPY_NEEDED
+/* Copy COUNT objects from SRC to DST.  The source and destination do
+   not overlap.  */
+# ifndef YYCOPY
+#  if defined __GNUC__ && 1 < __GNUC__
+#   define YYCOPY(Dst, Src, Count) \
+      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
+#  else
+#   define YYCOPY(Dst, Src, Count)              \
+      do                                        \
+        {                                       \
+          YYPTRDIFF_T yyi;                      \
+          for (yyi = 0; yyi < (Count); yyi++)   \
+            (Dst)[yyi] = (Src)[yyi];            \
+        }                                       \
+      while (0)
+#  endif
+# endif
+#endif /* !YYCOPY_NEEDED */
+
 /* YYFINAL -- State number of the termination state.  */
 #define YYFINAL  2
 /* YYLAST -- Last index in YYTABLE.  */
@@ -427,18 +622,23 @@ union yyalloc
 #define YYNNTS  3
 /* YYNRULES -- Number of rules.  */
 #define YYNRULES  55
-/* YYNRULES -- Number of states.  */
+/* YYNSTATES -- Number of states.  */
 #define YYNSTATES  176
 
-/* YYTRANSLATE(YYLEX) -- Bison symbol number corresponding to YYLEX.  */
-#define YYUNDEFTOK  2
+/* YYMAXUTOK -- Last valid token kind.  */
 #define YYMAXUTOK   292
 
-#define YYTRANSLATE(YYX)						\
-  ((unsigned int) (YYX) <= YYMAXUTOK ? yytranslate[YYX] : YYUNDEFTOK)
 
-/* YYTRANSLATE[YYLEX] -- Bison symbol number corresponding to YYLEX.  */
-static const yytype_uint8 yytranslate[] =
+/* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex, with out-of-bounds checking.  */
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
+
+/* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex.  */
+static const yytype_int8 yytranslate[] =
 {
        0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
@@ -473,152 +673,58 @@ static const yytype_uint8 yytranslate[] =
 };
 
 #if YYDEBUG
-/* YYPRHS[YYN] -- Index of the first RHS symbol of rule number YYN in
-   YYRHS.  */
-static const yytype_uint16 yyprhs[] =
-{
-       0,     0,     3,     4,     7,     9,    18,    24,    29,    41,
-      56,    59,    67,    82,    88,    95,   102,   110,   117,   125,
-     133,   142,   150,   159,   168,   178,   186,   195,   204,   214,
-     223,   233,   243,   254,   258,   263,   269,   273,   279,   284,
-     289,   293,   296,   299,   305,   308,   315,   317,   319,   321,
-     324,   327,   330,   333,   335,   337
-};
-
-/* YYRHS -- A `-1'-separated list of the rules' RHS.  */
-static const yytype_int8 yyrhs[] =
-{
-      39,     0,    -1,    -1,    39,    40,    -1,     3,    -1,     5,
-      17,     4,     4,     4,     4,     4,     4,    -1,    19,     4,
-       4,     4,    17,    -1,    19,     4,     4,     4,    -1,     7,
-      17,     4,     4,     4,     4,     4,     4,     4,     4,     4,
-      -1,     7,    17,     4,     4,     4,     4,     4,     4,     4,
-       4,     4,     4,     4,     4,    -1,     8,    17,    -1,     9,
-       4,     4,     4,     4,     4,     4,    -1,    16,    17,     4,
-       4,     4,     4,     4,     4,     4,     4,     4,     4,     4,
-       4,    -1,    10,     4,     4,     4,     4,    -1,    10,     4,
-       4,     4,     4,    17,    -1,    10,    17,     4,     4,     4,
-       4,    -1,    10,    17,     4,     4,     4,     4,    17,    -1,
-      11,     4,     4,     4,     4,     4,    -1,    11,     4,     4,
-       4,     4,     4,    17,    -1,    11,    17,     4,     4,     4,
-       4,     4,    -1,    11,    17,     4,     4,     4,     4,     4,
-      17,    -1,    12,     4,     4,     4,     4,     4,     4,    -1,
-      12,     4,     4,     4,     4,     4,     4,    17,    -1,    12,
-      17,     4,     4,     4,     4,     4,     4,    -1,    12,    17,
-       4,     4,     4,     4,     4,     4,    17,    -1,    13,     4,
-       4,     4,     4,     4,     4,    -1,    13,     4,     4,     4,
-      17,     4,     4,     4,    -1,    13,     4,     4,     4,     4,
-       4,     4,    17,    -1,    13,     4,     4,     4,    17,     4,
-       4,     4,    17,    -1,    13,    17,     4,     4,     4,     4,
-       4,     4,    -1,    13,    17,     4,     4,     4,    17,     4,
-       4,     4,    -1,    13,    17,     4,     4,     4,     4,     4,
-       4,    17,    -1,    13,    17,     4,     4,     4,    17,     4,
-       4,     4,    17,    -1,    15,    37,    17,    -1,    15,    17,
-      37,    17,    -1,    15,    17,    37,    17,    17,    -1,    18,
-      17,     4,    -1,    20,     4,     4,     4,    17,    -1,    20,
-       4,     4,     4,    -1,    21,    17,     4,    17,    -1,    21,
-      17,     4,    -1,    22,    17,    -1,    23,    17,    -1,    24,
-       4,     4,    17,    17,    -1,    25,     4,    -1,    26,    17,
-       4,     4,     4,     4,    -1,    27,    -1,    30,    -1,    28,
-      -1,    29,    17,    -1,    31,    32,    -1,    33,     4,    -1,
-      34,     4,    -1,    35,    -1,    36,    -1,     6,     4,     4,
-       4,    -1
-};
-
-/* YYRLINE[YYN] -- source line where rule number YYN was defined.  */
-static const yytype_uint16 yyrline[] =
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+static const yytype_int16 yyrline[] =
 {
-       0,    42,    42,    43,    47,    49,    69,    81,    93,   121,
-     148,   157,   171,   193,   206,   220,   234,   251,   266,   281,
-     297,   314,   331,   349,   366,   387,   405,   423,   441,   461,
-     479,   498,   518,   538,   547,   557,   568,   577,   588,   599,
-     624,   647,   654,   661,   671,   678,   689,   695,   701,   707,
-     714,   721,   728,   735,   741,   747
+       0,    48,    48,    49,    53,    55,    75,    88,   101,   129,
+     156,   164,   178,   200,   213,   226,   240,   256,   271,   285,
+     301,   317,   334,   351,   368,   388,   406,   423,   440,   458,
+     476,   494,   513,   531,   540,   550,   560,   570,   582,   594,
+     620,   644,   651,   658,   668,   675,   687,   693,   699,   705,
+     712,   719,   726,   733,   739,   745
 };
 #endif
 
-#if YYDEBUG || YYERROR_VERBOSE || YYTOKEN_TABLE
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if YYDEBUG || 0
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
 /* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
    First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
 static const char *const yytname[] =
 {
-  "$end", "error", "$undefined", "COMMENT", "DOUBLE", "LIGHT", "AMBIENT",
-  "CONSTANTS", "SAVE_COORDS", "CAMERA", "SPHERE", "TORUS", "BOX", "LINE",
-  "CS", "MESH", "TEXTURE", "STRING", "SET", "MOVE", "SCALE", "ROTATE",
-  "BASENAME", "SAVE_KNOBS", "TWEEN", "FRAMES", "VARY", "PUSH", "POP",
-  "SAVE", "GENERATE_RAYFILES", "SHADING", "SHADING_TYPE", "SETKNOBS",
-  "FOCAL", "DISPLAY", "WEB", "CO", "$accept", "input", "command", 0
+  "\"end of file\"", "error", "\"invalid token\"", "COMMENT", "DOUBLE",
+  "LIGHT", "AMBIENT", "CONSTANTS", "SAVE_COORDS", "CAMERA", "SPHERE",
+  "TORUS", "BOX", "LINE", "CS", "MESH", "TEXTURE", "STRING", "SET", "MOVE",
+  "SCALE", "ROTATE", "BASENAME", "SAVE_KNOBS", "TWEEN", "FRAMES", "VARY",
+  "PUSH", "POP", "SAVE", "GENERATE_RAYFILES", "SHADING", "SHADING_TYPE",
+  "SETKNOBS", "FOCAL", "DISPLAY", "WEB", "CO", "$accept", "input",
+  "command", YY_NULLPTR
 };
-#endif
 
-# ifdef YYPRINT
-/* YYTOKNUM[YYLEX-NUM] -- Internal token number corresponding to
-   token YYLEX-NUM.  */
-static const yytype_uint16 yytoknum[] =
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
 {
-       0,   256,   257,   258,   259,   260,   261,   262,   263,   264,
-     265,   266,   267,   268,   269,   270,   271,   272,   273,   274,
-     275,   276,   277,   278,   279,   280,   281,   282,   283,   284,
-     285,   286,   287,   288,   289,   290,   291,   292
-};
-# endif
+  return yytname[yysymbol];
+}
+#endif
 
-/* YYR1[YYN] -- Symbol number of symbol that rule YYN derives.  */
-static const yytype_uint8 yyr1[] =
-{
-       0,    38,    39,    39,    40,    40,    40,    40,    40,    40,
-      40,    40,    40,    40,    40,    40,    40,    40,    40,    40,
-      40,    40,    40,    40,    40,    40,    40,    40,    40,    40,
-      40,    40,    40,    40,    40,    40,    40,    40,    40,    40,
-      40,    40,    40,    40,    40,    40,    40,    40,    40,    40,
-      40,    40,    40,    40,    40,    40
-};
+#define YYPACT_NINF (-16)
 
-/* YYR2[YYN] -- Number of symbols composing right hand side of rule YYN.  */
-static const yytype_uint8 yyr2[] =
-{
-       0,     2,     0,     2,     1,     8,     5,     4,    11,    14,
-       2,     7,    14,     5,     6,     6,     7,     6,     7,     7,
-       8,     7,     8,     8,     9,     7,     8,     8,     9,     8,
-       9,     9,    10,     3,     4,     5,     3,     5,     4,     4,
-       3,     2,     2,     5,     2,     6,     1,     1,     1,     2,
-       2,     2,     2,     1,     1,     4
-};
+#define yypact_value_is_default(Yyn) \
+  ((Yyn) == YYPACT_NINF)
 
-/* YYDEFACT[STATE-NAME] -- Default rule to reduce with in state
-   STATE-NUM when YYTABLE doesn't specify something else to do.  Zero
-   means the default is an error.  */
-static const yytype_uint8 yydefact[] =
-{
-       2,     0,     1,     4,     0,     0,     0,     0,     0,     0,
-       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-       0,     0,     0,     0,    46,    48,     0,    47,     0,     0,
-       0,    53,    54,     3,     0,     0,     0,    10,     0,     0,
-       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-       0,     0,     0,     0,    41,    42,     0,    44,     0,    49,
-      50,    51,    52,     0,     0,     0,     0,     0,     0,     0,
-       0,     0,     0,     0,     0,     0,    33,     0,    36,     0,
-       0,    40,     0,     0,     0,    55,     0,     0,     0,     0,
-       0,     0,     0,     0,     0,     0,    34,     0,     7,    38,
-      39,     0,     0,     0,     0,     0,    13,     0,     0,     0,
-       0,     0,     0,     0,     0,    35,     0,     6,    37,    43,
-       0,     0,     0,     0,    14,    15,    17,     0,     0,     0,
-       0,     0,     0,     0,     0,    45,     0,     0,    11,    16,
-      18,    19,    21,     0,    25,     0,     0,     0,     0,     5,
-       0,    20,    22,    23,    27,    26,    29,     0,     0,     0,
-      24,    28,    31,    30,     0,     0,    32,     0,     8,     0,
-       0,     0,     0,     0,     9,    12
-};
+#define YYTABLE_NINF (-1)
 
-/* YYDEFGOTO[NTERM-NUM].  */
-static const yytype_int8 yydefgoto[] =
-{
-      -1,     1,    33
-};
+#define yytable_value_is_error(Yyn) \
+  0
 
 /* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
    STATE-NUM.  */
-#define YYPACT_NINF -16
 static const yytype_int16 yypact[] =
 {
      -16,     0,   -16,   -16,   -15,    13,   -13,    22,    39,    -3,
@@ -641,17 +747,46 @@ static const yytype_int16 yypact[] =
      171,   172,   173,   175,   -16,   -16
 };
 
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
+static const yytype_int8 yydefact[] =
+{
+       2,     0,     1,     4,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,    46,    48,     0,    47,     0,     0,
+       0,    53,    54,     3,     0,     0,     0,    10,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,    41,    42,     0,    44,     0,    49,
+      50,    51,    52,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,    33,     0,    36,     0,
+       0,    40,     0,     0,     0,    55,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,    34,     0,     7,    38,
+      39,     0,     0,     0,     0,     0,    13,     0,     0,     0,
+       0,     0,     0,     0,     0,    35,     0,     6,    37,    43,
+       0,     0,     0,     0,    14,    15,    17,     0,     0,     0,
+       0,     0,     0,     0,     0,    45,     0,     0,    11,    16,
+      18,    19,    21,     0,    25,     0,     0,     0,     0,     5,
+       0,    20,    22,    23,    27,    26,    29,     0,     0,     0,
+      24,    28,    31,    30,     0,     0,    32,     0,     8,     0,
+       0,     0,     0,     0,     9,    12
+};
+
 /* YYPGOTO[NTERM-NUM].  */
 static const yytype_int8 yypgoto[] =
 {
      -16,   -16,   -16
 };
 
-/* YYTABLE[YYPACT[STATE-NUM]].  What to do in state STATE-NUM.  If
-   positive, shift that token.  If negative, reduce the rule which
-   number is the opposite.  If zero, do what YYDEFACT says.
-   If YYTABLE_NINF, syntax error.  */
-#define YYTABLE_NINF -1
+/* YYDEFGOTO[NTERM-NUM].  */
+static const yytype_int8 yydefgoto[] =
+{
+       0,     1,    33
+};
+
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
 static const yytype_uint8 yytable[] =
 {
        2,    39,    34,     3,    36,     4,     5,     6,     7,     8,
@@ -696,9 +831,9 @@ static const yytype_int8 yycheck[] =
        4,     4,     4,    17,    17,     4,     4,     4,    17,     4
 };
 
-/* YYSTOS[STATE-NUM] -- The (internal number of the) accessing
-   symbol of state STATE-NUM.  */
-static const yytype_uint8 yystos[] =
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_int8 yystos[] =
 {
        0,    39,     0,     3,     5,     6,     7,     8,     9,    10,
       11,    12,    13,    15,    16,    18,    19,    20,    21,    22,
@@ -720,95 +855,63 @@ static const yytype_uint8 yystos[] =
        4,     4,     4,     4,     4,     4
 };
 
-#define yyerrok		(yyerrstatus = 0)
-#define yyclearin	(yychar = YYEMPTY)
-#define YYEMPTY		(-2)
-#define YYEOF		0
-
-#define YYACCEPT	goto yyacceptlab
-#define YYABORT		goto yyabortlab
-#define YYERROR		goto yyerrorlab
-
-
-/* Like YYERROR except do call yyerror.  This remains here temporarily
-   to ease the transition to the new meaning of YYERROR, for GCC.
-   Once GCC version 2 has supplanted version 1, this can go.  */
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr1[] =
+{
+       0,    38,    39,    39,    40,    40,    40,    40,    40,    40,
+      40,    40,    40,    40,    40,    40,    40,    40,    40,    40,
+      40,    40,    40,    40,    40,    40,    40,    40,    40,    40,
+      40,    40,    40,    40,    40,    40,    40,    40,    40,    40,
+      40,    40,    40,    40,    40,    40,    40,    40,    40,    40,
+      40,    40,    40,    40,    40,    40
+};
 
-#define YYFAIL		goto yyerrlab
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr2[] =
+{
+       0,     2,     0,     2,     1,     8,     5,     4,    11,    14,
+       2,     7,    14,     5,     6,     6,     7,     6,     7,     7,
+       8,     7,     8,     8,     9,     7,     8,     8,     9,     8,
+       9,     9,    10,     3,     4,     5,     3,     5,     4,     4,
+       3,     2,     2,     5,     2,     6,     1,     1,     1,     2,
+       2,     2,     2,     1,     1,     4
+};
 
-#define YYRECOVERING()  (!!yyerrstatus)
 
-#define YYBACKUP(Token, Value)					\
-do								\
-  if (yychar == YYEMPTY && yylen == 1)				\
-    {								\
-      yychar = (Token);						\
-      yylval = (Value);						\
-      yytoken = YYTRANSLATE (yychar);				\
-      YYPOPSTACK (1);						\
-      goto yybackup;						\
-    }								\
-  else								\
-    {								\
-      yyerror (YY_("syntax error: cannot back up")); \
-      YYERROR;							\
-    }								\
-while (YYID (0))
-
-
-#define YYTERROR	1
-#define YYERRCODE	256
-
-
-/* YYLLOC_DEFAULT -- Set CURRENT to span from RHS[1] to RHS[N].
-   If N is 0, then set CURRENT to the empty location which ends
-   the previous symbol: RHS[0] (always defined).  */
-
-#define YYRHSLOC(Rhs, K) ((Rhs)[K])
-#ifndef YYLLOC_DEFAULT
-# define YYLLOC_DEFAULT(Current, Rhs, N)				\
-    do									\
-      if (YYID (N))                                                    \
-	{								\
-	  (Current).first_line   = YYRHSLOC (Rhs, 1).first_line;	\
-	  (Current).first_column = YYRHSLOC (Rhs, 1).first_column;	\
-	  (Current).last_line    = YYRHSLOC (Rhs, N).last_line;		\
-	  (Current).last_column  = YYRHSLOC (Rhs, N).last_column;	\
-	}								\
-      else								\
-	{								\
-	  (Current).first_line   = (Current).last_line   =		\
-	    YYRHSLOC (Rhs, 0).last_line;				\
-	  (Current).first_column = (Current).last_column =		\
-	    YYRHSLOC (Rhs, 0).last_column;				\
-	}								\
-    while (YYID (0))
-#endif
+enum { YYENOMEM = -2 };
 
+#define yyerrok         (yyerrstatus = 0)
+#define yyclearin       (yychar = YYEMPTY)
 
-/* YY_LOCATION_PRINT -- Print the location on the stream.
-   This macro was not mandated originally: define only if we know
-   we won't break user code: when these are the locations we know.  */
+#define YYACCEPT        goto yyacceptlab
+#define YYABORT         goto yyabortlab
+#define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
 
-#ifndef YY_LOCATION_PRINT
-# if defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL
-#  define YY_LOCATION_PRINT(File, Loc)			\
-     fprintf (File, "%d.%d-%d.%d",			\
-	      (Loc).first_line, (Loc).first_column,	\
-	      (Loc).last_line,  (Loc).last_column)
-# else
-#  define YY_LOCATION_PRINT(File, Loc) ((void) 0)
-# endif
-#endif
 
+#define YYRECOVERING()  (!!yyerrstatus)
 
-/* YYLEX -- calling `yylex' with the right arguments.  */
+#define YYBACKUP(Token, Value)                                    \
+  do                                                              \
+    if (yychar == YYEMPTY)                                        \
+      {                                                           \
+        yychar = (Token);                                         \
+        yylval = (Value);                                         \
+        YYPOPSTACK (yylen);                                       \
+        yystate = *yyssp;                                         \
+        goto yybackup;                                            \
+      }                                                           \
+    else                                                          \
+      {                                                           \
+        yyerror (YY_("syntax error: cannot back up")); \
+        YYERROR;                                                  \
+      }                                                           \
+  while (0)
+
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
 
-#ifdef YYLEX_PARAM
-# define YYLEX yylex (YYLEX_PARAM)
-#else
-# define YYLEX yylex ()
-#endif
 
 /* Enable debugging if requested.  */
 #if YYDEBUG
@@ -818,80 +921,58 @@ while (YYID (0))
 #  define YYFPRINTF fprintf
 # endif
 
-# define YYDPRINTF(Args)			\
-do {						\
-  if (yydebug)					\
-    YYFPRINTF Args;				\
-} while (YYID (0))
-
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)			  \
-do {									  \
-  if (yydebug)								  \
-    {									  \
-      YYFPRINTF (stderr, "%s ", Title);					  \
-      yy_symbol_print (stderr,						  \
-		  Type, Value); \
-      YYFPRINTF (stderr, "\n");						  \
-    }									  \
-} while (YYID (0))
-
-
-/*--------------------------------.
-| Print this symbol on YYOUTPUT.  |
-`--------------------------------*/
-
-/*ARGSUSED*/
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static void
-yy_symbol_value_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep)
-#else
+# define YYDPRINTF(Args)                        \
+do {                                            \
+  if (yydebug)                                  \
+    YYFPRINTF Args;                             \
+} while (0)
+
+
+
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
+do {                                                                      \
+  if (yydebug)                                                            \
+    {                                                                     \
+      YYFPRINTF (stderr, "%s ", Title);                                   \
+      yy_symbol_print (stderr,                                            \
+                  Kind, Value); \
+      YYFPRINTF (stderr, "\n");                                           \
+    }                                                                     \
+} while (0)
+
+
+/*-----------------------------------.
+| Print this symbol's value on YYO.  |
+`-----------------------------------*/
+
 static void
-yy_symbol_value_print (yyoutput, yytype, yyvaluep)
-    FILE *yyoutput;
-    int yytype;
-    YYSTYPE const * const yyvaluep;
-#endif
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep)
 {
+  FILE *yyoutput = yyo;
+  YY_USE (yyoutput);
   if (!yyvaluep)
     return;
-# ifdef YYPRINT
-  if (yytype < YYNTOKENS)
-    YYPRINT (yyoutput, yytoknum[yytype], *yyvaluep);
-# else
-  YYUSE (yyoutput);
-# endif
-  switch (yytype)
-    {
-      default:
-	break;
-    }
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
 
-/*--------------------------------.
-| Print this symbol on YYOUTPUT.  |
-`--------------------------------*/
+/*---------------------------.
+| Print this symbol on YYO.  |
+`---------------------------*/
 
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static void
-yy_symbol_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep)
-#else
 static void
-yy_symbol_print (yyoutput, yytype, yyvaluep)
-    FILE *yyoutput;
-    int yytype;
-    YYSTYPE const * const yyvaluep;
-#endif
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep)
 {
-  if (yytype < YYNTOKENS)
-    YYFPRINTF (yyoutput, "token %s (", yytname[yytype]);
-  else
-    YYFPRINTF (yyoutput, "nterm %s (", yytname[yytype]);
+  YYFPRINTF (yyo, "%s %s (",
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
 
-  yy_symbol_value_print (yyoutput, yytype, yyvaluep);
-  YYFPRINTF (yyoutput, ")");
+  yy_symbol_value_print (yyo, yykind, yyvaluep);
+  YYFPRINTF (yyo, ")");
 }
 
 /*------------------------------------------------------------------.
@@ -899,80 +980,68 @@ yy_symbol_print (yyoutput, yytype, yyvaluep)
 | TOP (included).                                                   |
 `------------------------------------------------------------------*/
 
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
 static void
-yy_stack_print (yytype_int16 *bottom, yytype_int16 *top)
-#else
-static void
-yy_stack_print (bottom, top)
-    yytype_int16 *bottom;
-    yytype_int16 *top;
-#endif
+yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
 {
   YYFPRINTF (stderr, "Stack now");
-  for (; bottom <= top; ++bottom)
-    YYFPRINTF (stderr, " %d", *bottom);
+  for (; yybottom <= yytop; yybottom++)
+    {
+      int yybot = *yybottom;
+      YYFPRINTF (stderr, " %d", yybot);
+    }
   YYFPRINTF (stderr, "\n");
 }
 
-# define YY_STACK_PRINT(Bottom, Top)				\
-do {								\
-  if (yydebug)							\
-    yy_stack_print ((Bottom), (Top));				\
-} while (YYID (0))
+# define YY_STACK_PRINT(Bottom, Top)                            \
+do {                                                            \
+  if (yydebug)                                                  \
+    yy_stack_print ((Bottom), (Top));                           \
+} while (0)
 
 
 /*------------------------------------------------.
 | Report that the YYRULE is going to be reduced.  |
 `------------------------------------------------*/
 
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
 static void
-yy_reduce_print (YYSTYPE *yyvsp, int yyrule)
-#else
-static void
-yy_reduce_print (yyvsp, yyrule)
-    YYSTYPE *yyvsp;
-    int yyrule;
-#endif
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
+                 int yyrule)
 {
+  int yylno = yyrline[yyrule];
   int yynrhs = yyr2[yyrule];
   int yyi;
-  unsigned long int yylno = yyrline[yyrule];
-  YYFPRINTF (stderr, "Reducing stack by rule %d (line %lu):\n",
-	     yyrule - 1, yylno);
+  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
+             yyrule - 1, yylno);
   /* The symbols being reduced.  */
   for (yyi = 0; yyi < yynrhs; yyi++)
     {
-      fprintf (stderr, "   $%d = ", yyi + 1);
-      yy_symbol_print (stderr, yyrhs[yyprhs[yyrule] + yyi],
-		       &(yyvsp[(yyi + 1) - (yynrhs)])
-		       		       );
-      fprintf (stderr, "\n");
+      YYFPRINTF (stderr, "   $%d = ", yyi + 1);
+      yy_symbol_print (stderr,
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)]);
+      YYFPRINTF (stderr, "\n");
     }
 }
 
-# define YY_REDUCE_PRINT(Rule)		\
-do {					\
-  if (yydebug)				\
-    yy_reduce_print (yyvsp, Rule); \
-} while (YYID (0))
+# define YY_REDUCE_PRINT(Rule)          \
+do {                                    \
+  if (yydebug)                          \
+    yy_reduce_print (yyssp, yyvsp, Rule); \
+} while (0)
 
 /* Nonzero means print parse trace.  It is left uninitialized so that
    multiple parsers can coexist.  */
 int yydebug;
 #else /* !YYDEBUG */
-# define YYDPRINTF(Args)
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
 # define YY_STACK_PRINT(Bottom, Top)
 # define YY_REDUCE_PRINT(Rule)
 #endif /* !YYDEBUG */
 
 
 /* YYINITDEPTH -- initial size of the parser's stacks.  */
-#ifndef	YYINITDEPTH
+#ifndef YYINITDEPTH
 # define YYINITDEPTH 200
 #endif
 
@@ -987,478 +1056,219 @@ int yydebug;
 # define YYMAXDEPTH 10000
 #endif
 
-
-
-#if YYERROR_VERBOSE
-
-# ifndef yystrlen
-#  if defined __GLIBC__ && defined _STRING_H
-#   define yystrlen strlen
-#  else
-/* Return the length of YYSTR.  */
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static YYSIZE_T
-yystrlen (const char *yystr)
-#else
-static YYSIZE_T
-yystrlen (yystr)
-    const char *yystr;
-#endif
-{
-  YYSIZE_T yylen;
-  for (yylen = 0; yystr[yylen]; yylen++)
-    continue;
-  return yylen;
-}
-#  endif
-# endif
-
-# ifndef yystpcpy
-#  if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
-#   define yystpcpy stpcpy
-#  else
-/* Copy YYSRC to YYDEST, returning the address of the terminating '\0' in
-   YYDEST.  */
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static char *
-yystpcpy (char *yydest, const char *yysrc)
-#else
-static char *
-yystpcpy (yydest, yysrc)
-    char *yydest;
-    const char *yysrc;
-#endif
-{
-  char *yyd = yydest;
-  const char *yys = yysrc;
-
-  while ((*yyd++ = *yys++) != '\0')
-    continue;
-
-  return yyd - 1;
-}
-#  endif
-# endif
-
-# ifndef yytnamerr
-/* Copy to YYRES the contents of YYSTR after stripping away unnecessary
-   quotes and backslashes, so that it's suitable for yyerror.  The
-   heuristic is that double-quoting is unnecessary unless the string
-   contains an apostrophe, a comma, or backslash (other than
-   backslash-backslash).  YYSTR is taken from yytname.  If YYRES is
-   null, do not copy; instead, return the length of what the result
-   would have been.  */
-static YYSIZE_T
-yytnamerr (char *yyres, const char *yystr)
-{
-  if (*yystr == '"')
-    {
-      YYSIZE_T yyn = 0;
-      char const *yyp = yystr;
-
-      for (;;)
-	switch (*++yyp)
-	  {
-	  case '\'':
-	  case ',':
-	    goto do_not_strip_quotes;
-
-	  case '\\':
-	    if (*++yyp != '\\')
-	      goto do_not_strip_quotes;
-	    /* Fall through.  */
-	  default:
-	    if (yyres)
-	      yyres[yyn] = *yyp;
-	    yyn++;
-	    break;
-
-	  case '"':
-	    if (yyres)
-	      yyres[yyn] = '\0';
-	    return yyn;
-	  }
-    do_not_strip_quotes: ;
-    }
 
-  if (! yyres)
-    return yystrlen (yystr);
 
-  return yystpcpy (yyres, yystr) - yyres;
-}
-# endif
 
-/* Copy into YYRESULT an error message about the unexpected token
-   YYCHAR while in state YYSTATE.  Return the number of bytes copied,
-   including the terminating null byte.  If YYRESULT is null, do not
-   copy anything; just return the number of bytes that would be
-   copied.  As a special case, return 0 if an ordinary "syntax error"
-   message will do.  Return YYSIZE_MAXIMUM if overflow occurs during
-   size calculation.  */
-static YYSIZE_T
-yysyntax_error (char *yyresult, int yystate, int yychar)
-{
-  int yyn = yypact[yystate];
 
-  if (! (YYPACT_NINF < yyn && yyn <= YYLAST))
-    return 0;
-  else
-    {
-      int yytype = YYTRANSLATE (yychar);
-      YYSIZE_T yysize0 = yytnamerr (0, yytname[yytype]);
-      YYSIZE_T yysize = yysize0;
-      YYSIZE_T yysize1;
-      int yysize_overflow = 0;
-      enum { YYERROR_VERBOSE_ARGS_MAXIMUM = 5 };
-      char const *yyarg[YYERROR_VERBOSE_ARGS_MAXIMUM];
-      int yyx;
-
-# if 0
-      /* This is so xgettext sees the translatable formats that are
-	 constructed on the fly.  */
-      YY_("syntax error, unexpected %s");
-      YY_("syntax error, unexpected %s, expecting %s");
-      YY_("syntax error, unexpected %s, expecting %s or %s");
-      YY_("syntax error, unexpected %s, expecting %s or %s or %s");
-      YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s");
-# endif
-      char *yyfmt;
-      char const *yyf;
-      static char const yyunexpected[] = "syntax error, unexpected %s";
-      static char const yyexpecting[] = ", expecting %s";
-      static char const yyor[] = " or %s";
-      char yyformat[sizeof yyunexpected
-		    + sizeof yyexpecting - 1
-		    + ((YYERROR_VERBOSE_ARGS_MAXIMUM - 2)
-		       * (sizeof yyor - 1))];
-      char const *yyprefix = yyexpecting;
-
-      /* Start YYX at -YYN if negative to avoid negative indexes in
-	 YYCHECK.  */
-      int yyxbegin = yyn < 0 ? -yyn : 0;
-
-      /* Stay within bounds of both yycheck and yytname.  */
-      int yychecklim = YYLAST - yyn + 1;
-      int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
-      int yycount = 1;
-
-      yyarg[0] = yytname[yytype];
-      yyfmt = yystpcpy (yyformat, yyunexpected);
-
-      for (yyx = yyxbegin; yyx < yyxend; ++yyx)
-	if (yycheck[yyx + yyn] == yyx && yyx != YYTERROR)
-	  {
-	    if (yycount == YYERROR_VERBOSE_ARGS_MAXIMUM)
-	      {
-		yycount = 1;
-		yysize = yysize0;
-		yyformat[sizeof yyunexpected - 1] = '\0';
-		break;
-	      }
-	    yyarg[yycount++] = yytname[yyx];
-	    yysize1 = yysize + yytnamerr (0, yytname[yyx]);
-	    yysize_overflow |= (yysize1 < yysize);
-	    yysize = yysize1;
-	    yyfmt = yystpcpy (yyfmt, yyprefix);
-	    yyprefix = yyor;
-	  }
-
-      yyf = YY_(yyformat);
-      yysize1 = yysize + yystrlen (yyf);
-      yysize_overflow |= (yysize1 < yysize);
-      yysize = yysize1;
-
-      if (yysize_overflow)
-	return YYSIZE_MAXIMUM;
-
-      if (yyresult)
-	{
-	  /* Avoid sprintf, as that infringes on the user's name space.
-	     Don't have undefined behavior even if the translation
-	     produced a string with the wrong number of "%s"s.  */
-	  char *yyp = yyresult;
-	  int yyi = 0;
-	  while ((*yyp = *yyf) != '\0')
-	    {
-	      if (*yyp == '%' && yyf[1] == 's' && yyi < yycount)
-		{
-		  yyp += yytnamerr (yyp, yyarg[yyi++]);
-		  yyf += 2;
-		}
-	      else
-		{
-		  yyp++;
-		  yyf++;
-		}
-	    }
-	}
-      return yysize;
-    }
-}
-#endif /* YYERROR_VERBOSE */
-
 
 /*-----------------------------------------------.
 | Release the memory associated to this symbol.  |
 `-----------------------------------------------*/
 
-/*ARGSUSED*/
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static void
-yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep)
-#else
 static void
-yydestruct (yymsg, yytype, yyvaluep)
-    const char *yymsg;
-    int yytype;
-    YYSTYPE *yyvaluep;
-#endif
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep)
 {
-  YYUSE (yyvaluep);
-
+  YY_USE (yyvaluep);
   if (!yymsg)
-    yymsg = "Deleting";
-  YY_SYMBOL_PRINT (yymsg, yytype, yyvaluep, yylocationp);
-
-  switch (yytype)
-    {
-
-      default:
-	break;
-    }
-}
-
-
-/* Prevent warnings from -Wmissing-prototypes.  */
-
-#ifdef YYPARSE_PARAM
-#if defined __STDC__ || defined __cplusplus
-int yyparse (void *YYPARSE_PARAM);
-#else
-int yyparse ();
-#endif
-#else /* ! YYPARSE_PARAM */
-#if defined __STDC__ || defined __cplusplus
-int yyparse (void);
-#else
-int yyparse ();
-#endif
-#endif /* ! YYPARSE_PARAM */
+    yymsg = "Deleting";
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
 
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
 
 
-/* The look-ahead symbol.  */
+/* Lookahead token kind.  */
 int yychar;
 
-/* The semantic value of the look-ahead symbol.  */
+/* The semantic value of the lookahead symbol.  */
 YYSTYPE yylval;
-
 /* Number of syntax errors so far.  */
 int yynerrs;
 
 
 
+
 /*----------.
 | yyparse.  |
 `----------*/
 
-#ifdef YYPARSE_PARAM
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-int
-yyparse (void *YYPARSE_PARAM)
-#else
-int
-yyparse (YYPARSE_PARAM)
-    void *YYPARSE_PARAM;
-#endif
-#else /* ! YYPARSE_PARAM */
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
 int
 yyparse (void)
-#else
-int
-yyparse ()
-
-#endif
-#endif
 {
-  
-  int yystate;
-  int yyn;
-  int yyresult;
-  /* Number of tokens to shift before error messages enabled.  */
-  int yyerrstatus;
-  /* Look-ahead token as an internal (translated) token number.  */
-  int yytoken = 0;
-#if YYERROR_VERBOSE
-  /* Buffer for error messages, and its allocated size.  */
-  char yymsgbuf[128];
-  char *yymsg = yymsgbuf;
-  YYSIZE_T yymsg_alloc = sizeof yymsgbuf;
-#endif
-
-  /* Three stacks and their tools:
-     `yyss': related to states,
-     `yyvs': related to semantic values,
-     `yyls': related to locations.
-
-     Refer to the stacks thru separate pointers, to allow yyoverflow
-     to reallocate them elsewhere.  */
-
-  /* The state stack.  */
-  yytype_int16 yyssa[YYINITDEPTH];
-  yytype_int16 *yyss = yyssa;
-  yytype_int16 *yyssp;
+    yy_state_fast_t yystate = 0;
+    /* Number of tokens to shift before error messages enabled.  */
+    int yyerrstatus = 0;
 
-  /* The semantic value stack.  */
-  YYSTYPE yyvsa[YYINITDEPTH];
-  YYSTYPE *yyvs = yyvsa;
-  YYSTYPE *yyvsp;
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
+       to reallocate them elsewhere.  */
 
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
 
+    /* The state stack: array, bottom, top.  */
+    yy_state_t yyssa[YYINITDEPTH];
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
 
-#define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
-
-  YYSIZE_T yystacksize = YYINITDEPTH;
+    /* The semantic value stack: array, bottom, top.  */
+    YYSTYPE yyvsa[YYINITDEPTH];
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
 
+  int yyn;
+  /* The return value of yyparse.  */
+  int yyresult;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
   /* The variables used to return semantic value and location from the
      action routines.  */
   YYSTYPE yyval;
 
 
+
+#define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
+
   /* The number of symbols on the RHS of the reduced rule.
      Keep to zero when no symbol should be popped.  */
   int yylen = 0;
 
   YYDPRINTF ((stderr, "Starting parse\n"));
 
-  yystate = 0;
-  yyerrstatus = 0;
-  yynerrs = 0;
-  yychar = YYEMPTY;		/* Cause a token to be read.  */
-
-  /* Initialize stack pointers.
-     Waste one element of value and location stack
-     so that they stay on the same level as the state stack.
-     The wasted elements are never initialized.  */
-
-  yyssp = yyss;
-  yyvsp = yyvs;
+  yychar = YYEMPTY; /* Cause a token to be read.  */
 
   goto yysetstate;
 
+
 /*------------------------------------------------------------.
-| yynewstate -- Push a new state, which is found in yystate.  |
+| yynewstate -- push a new state, which is found in yystate.  |
 `------------------------------------------------------------*/
- yynewstate:
+yynewstate:
   /* In all cases, when you get here, the value and location stacks
      have just been pushed.  So pushing a state here evens the stacks.  */
   yyssp++;
 
- yysetstate:
-  *yyssp = yystate;
+
+/*--------------------------------------------------------------------.
+| yysetstate -- set current state (the top of the stack) to yystate.  |
+`--------------------------------------------------------------------*/
+yysetstate:
+  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
+  YY_IGNORE_USELESS_CAST_BEGIN
+  *yyssp = YY_CAST (yy_state_t, yystate);
+  YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
 
   if (yyss + yystacksize - 1 <= yyssp)
+#if !defined yyoverflow && !defined YYSTACK_RELOCATE
+    YYNOMEM;
+#else
     {
       /* Get the current used size of the three stacks, in elements.  */
-      YYSIZE_T yysize = yyssp - yyss + 1;
+      YYPTRDIFF_T yysize = yyssp - yyss + 1;
 
-#ifdef yyoverflow
+# if defined yyoverflow
       {
-	/* Give user a chance to reallocate the stack.  Use copies of
-	   these so that the &'s don't force the real ones into
-	   memory.  */
-	YYSTYPE *yyvs1 = yyvs;
-	yytype_int16 *yyss1 = yyss;
-
-
-	/* Each stack pointer address is followed by the size of the
-	   data in use in that stack, in bytes.  This used to be a
-	   conditional around just the two extra args, but that might
-	   be undefined if yyoverflow is a macro.  */
-	yyoverflow (YY_("memory exhausted"),
-		    &yyss1, yysize * sizeof (*yyssp),
-		    &yyvs1, yysize * sizeof (*yyvsp),
-
-		    &yystacksize);
-
-	yyss = yyss1;
-	yyvs = yyvs1;
+        /* Give user a chance to reallocate the stack.  Use copies of
+           these so that the &'s don't force the real ones into
+           memory.  */
+        yy_state_t *yyss1 = yyss;
+        YYSTYPE *yyvs1 = yyvs;
+
+        /* Each stack pointer address is followed by the size of the
+           data in use in that stack, in bytes.  This used to be a
+           conditional around just the two extra args, but that might
+           be undefined if yyoverflow is a macro.  */
+        yyoverflow (YY_("memory exhausted"),
+                    &yyss1, yysize * YYSIZEOF (*yyssp),
+                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
+                    &yystacksize);
+        yyss = yyss1;
+        yyvs = yyvs1;
       }
-#else /* no yyoverflow */
-# ifndef YYSTACK_RELOCATE
-      goto yyexhaustedlab;
-# else
+# else /* defined YYSTACK_RELOCATE */
       /* Extend the stack our own way.  */
       if (YYMAXDEPTH <= yystacksize)
-	goto yyexhaustedlab;
+        YYNOMEM;
       yystacksize *= 2;
       if (YYMAXDEPTH < yystacksize)
-	yystacksize = YYMAXDEPTH;
+        yystacksize = YYMAXDEPTH;
 
       {
-	yytype_int16 *yyss1 = yyss;
-	union yyalloc *yyptr =
-	  (union yyalloc *) YYSTACK_ALLOC (YYSTACK_BYTES (yystacksize));
-	if (! yyptr)
-	  goto yyexhaustedlab;
-	YYSTACK_RELOCATE (yyss);
-	YYSTACK_RELOCATE (yyvs);
-
+        yy_state_t *yyss1 = yyss;
+        union yyalloc *yyptr =
+          YY_CAST (union yyalloc *,
+                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
+        if (! yyptr)
+          YYNOMEM;
+        YYSTACK_RELOCATE (yyss_alloc, yyss);
+        YYSTACK_RELOCATE (yyvs_alloc, yyvs);
 #  undef YYSTACK_RELOCATE
-	if (yyss1 != yyssa)
-	  YYSTACK_FREE (yyss1);
+        if (yyss1 != yyssa)
+          YYSTACK_FREE (yyss1);
       }
 # endif
-#endif /* no yyoverflow */
 
       yyssp = yyss + yysize - 1;
       yyvsp = yyvs + yysize - 1;
 
-
-      YYDPRINTF ((stderr, "Stack size increased to %lu\n",
-		  (unsigned long int) yystacksize));
+      YY_IGNORE_USELESS_CAST_BEGIN
+      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
+                  YY_CAST (long, yystacksize)));
+      YY_IGNORE_USELESS_CAST_END
 
       if (yyss + yystacksize - 1 <= yyssp)
-	YYABORT;
+        YYABORT;
     }
+#endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
 
-  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+
+  if (yystate == YYFINAL)
+    YYACCEPT;
 
   goto yybackup;
 
+
 /*-----------.
 | yybackup.  |
 `-----------*/
 yybackup:
-
   /* Do appropriate processing given the current state.  Read a
-     look-ahead token if we need one and don't already have one.  */
+     lookahead token if we need one and don't already have one.  */
 
-  /* First try to decide what to do without reference to look-ahead token.  */
+  /* First try to decide what to do without reference to lookahead token.  */
   yyn = yypact[yystate];
-  if (yyn == YYPACT_NINF)
+  if (yypact_value_is_default (yyn))
     goto yydefault;
 
-  /* Not known => get a look-ahead token if don't already have one.  */
+  /* Not known => get a lookahead token if don't already have one.  */
 
-  /* YYCHAR is either YYEMPTY or YYEOF or a valid look-ahead symbol.  */
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
   if (yychar == YYEMPTY)
     {
-      YYDPRINTF ((stderr, "Reading a token: "));
-      yychar = YYLEX;
+      YYDPRINTF ((stderr, "Reading a token\n"));
+      yychar = yylex ();
     }
 
   if (yychar <= YYEOF)
     {
-      yychar = yytoken = YYEOF;
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
       YYDPRINTF ((stderr, "Now at end of input.\n"));
     }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      goto yyerrlab1;
+    }
   else
     {
       yytoken = YYTRANSLATE (yychar);
@@ -1473,30 +1283,26 @@ yybackup:
   yyn = yytable[yyn];
   if (yyn <= 0)
     {
-      if (yyn == 0 || yyn == YYTABLE_NINF)
-	goto yyerrlab;
+      if (yytable_value_is_error (yyn))
+        goto yyerrlab;
       yyn = -yyn;
       goto yyreduce;
     }
 
-  if (yyn == YYFINAL)
-    YYACCEPT;
-
   /* Count tokens shifted since error; after three, turn off error
      status.  */
   if (yyerrstatus)
     yyerrstatus--;
 
-  /* Shift the look-ahead token.  */
+  /* Shift the lookahead token.  */
   YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
-
-  /* Discard the shifted token unless it is eof.  */
-  if (yychar != YYEOF)
-    yychar = YYEMPTY;
-
   yystate = yyn;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
   *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 
+  /* Discard the shifted token.  */
+  yychar = YYEMPTY;
   goto yynewstate;
 
 
@@ -1511,14 +1317,14 @@ yydefault:
 
 
 /*-----------------------------.
-| yyreduce -- Do a reduction.  |
+| yyreduce -- do a reduction.  |
 `-----------------------------*/
 yyreduce:
   /* yyn is the number of a rule to reduce with.  */
   yylen = yyr2[yyn];
 
   /* If YYLEN is nonzero, implement the default value of the action:
-     `$$ = $1'.
+     '$$ = $1'.
 
      Otherwise, the following line sets YYVAL to garbage.
      This behavior is undocumented and Bison
@@ -1531,658 +1337,682 @@ yyreduce:
   YY_REDUCE_PRINT (yyn);
   switch (yyn)
     {
-        case 4:
-#line 47 "mdl.y"
-    {}
+  case 4: /* command: COMMENT  */
+#line 53 "mdl.y"
+        {}
+#line 1344 "y.tab.c"
     break;
 
-  case 5:
-#line 50 "mdl.y"
-    {
+  case 5: /* command: LIGHT STRING DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE  */
+#line 56 "mdl.y"
+{
   lineno++;
   l = (struct light *)malloc(sizeof(struct light));
-  l->l[0]= (yyvsp[(3) - (8)].val);
-  l->l[1]= (yyvsp[(4) - (8)].val);
-  l->l[2]= (yyvsp[(5) - (8)].val);
+  l->l[0]= (yyvsp[-5].val);
+  l->l[1]= (yyvsp[-4].val);
+  l->l[2]= (yyvsp[-3].val);
   l->l[3]= 0;
-  l->c[0]= (yyvsp[(6) - (8)].val);
-  l->c[1]= (yyvsp[(7) - (8)].val);
-  l->c[2]= (yyvsp[(8) - (8)].val);
+  l->c[0]= (yyvsp[-2].val);
+  l->c[1]= (yyvsp[-1].val);
+  l->c[2]= (yyvsp[0].val);
   op[lastop].opcode=LIGHT;
-  op[lastop].op.light.c[0] = (yyvsp[(6) - (8)].val); 
-  op[lastop].op.light.c[1] = (yyvsp[(7) - (8)].val);
-  op[lastop].op.light.c[2] = (yyvsp[(8) - (8)].val);
+  op[lastop].op.light.c[0] = (yyvsp[-2].val); 
+  op[lastop].op.light.c[1] = (yyvsp[-1].val);
+  op[lastop].op.light.c[2] = (yyvsp[0].val);
   op[lastop].op.light.c[3] = 0;
-  op[lastop].op.light.p = add_symbol((yyvsp[(2) - (8)].string),SYM_LIGHT,l);
-  lastop++;
+  op[lastop].op.light.p = add_symbol((yyvsp[-6].string),SYM_LIGHT,l);
+  next_op();
 }
+#line 1367 "y.tab.c"
     break;
 
-  case 6:
-#line 70 "mdl.y"
-    { 
+  case 6: /* command: MOVE DOUBLE DOUBLE DOUBLE STRING  */
+#line 76 "mdl.y"
+{ 
   lineno++;
   op[lastop].opcode = MOVE;
-  op[lastop].op.move.d[0] = (yyvsp[(2) - (5)].val);
-  op[lastop].op.move.d[1] = (yyvsp[(3) - (5)].val);
-  op[lastop].op.move.d[2] = (yyvsp[(4) - (5)].val);
+  op[lastop].op.move.d[0] = (yyvsp[-3].val);
+  op[lastop].op.move.d[1] = (yyvsp[-2].val);
+  op[lastop].op.move.d[2] = (yyvsp[-1].val);
   op[lastop].op.move.d[3] = 0;
-  op[lastop].op.move.p = add_symbol((yyvsp[(5) - (5)].string),SYM_VALUE,0);
-  lastop++;
+  op[lastop].op.move.p = add_symbol((yyvsp[0].string),SYM_VALUE,0);
+  op[lastop].op.move.knob = knob_slot(op[lastop].op.move.p);
+  next_op();
 }
+#line 1383 "y.tab.c"
     break;
 
-  case 7:
-#line 82 "mdl.y"
-    {
+  case 7: /* command: MOVE DOUBLE DOUBLE DOUBLE  */
+#line 89 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = MOVE;
-  op[lastop].op.move.d[0] = (yyvsp[(2) - (4)].val);
-  op[lastop].op.move.d[1] = (yyvsp[(3) - (4)].val);
-  op[lastop].op.move.d[2] = (yyvsp[(4) - (4)].val);
+  op[lastop].op.move.d[0] = (yyvsp[-2].val);
+  op[lastop].op.move.d[1] = (yyvsp[-1].val);
+  op[lastop].op.move.d[2] = (yyvsp[0].val);
   op[lastop].op.move.d[3] = 0;
   op[lastop].op.move.p = NULL;
-  lastop++;
+  op[lastop].op.move.knob = -1;
+  next_op();
 }
+#line 1399 "y.tab.c"
     break;
 
-  case 8:
-#line 94 "mdl.y"
-    {
+  case 8: /* command: CONSTANTS STRING DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE  */
+#line 102 "mdl.y"
+{
   lineno++;
   c = (struct constants *)malloc(sizeof(struct constants));
-  c->r[0]=(yyvsp[(3) - (11)].val);
-  c->r[1]=(yyvsp[(4) - (11)].val);
-  c->r[2]=(yyvsp[(5) - (11)].val);
+  c->r[0]=(yyvsp[-8].val);
+  c->r[1]=(yyvsp[-7].val);
+  c->r[2]=(yyvsp[-6].val);
   c->r[3]=0;
 
-  c->g[0]=(yyvsp[(6) - (11)].val);
-  c->g[1]=(yyvsp[(7) - (11)].val);
-  c->g[2]=(yyvsp[(8) - (11)].val);
+  c->g[0]=(yyvsp[-5].val);
+  c->g[1]=(yyvsp[-4].val);
+  c->g[2]=(yyvsp[-3].val);
   c->g[3]=0;
 
-  c->b[0]=(yyvsp[(9) - (11)].val);
-  c->b[1]=(yyvsp[(10) - (11)].val);
-  c->b[2]=(yyvsp[(11) - (11)].val);
+  c->b[0]=(yyvsp[-2].val);
+  c->b[1]=(yyvsp[-1].val);
+  c->b[2]=(yyvsp[0].val);
   c->b[3]=0;
 
   c->red = 0;
   c->green = 0;
   c->blue = 0;
 
-  op[lastop].op.constants.p =  add_symbol((yyvsp[(2) - (11)].string),SYM_CONSTANTS,c);
+  op[lastop].op.constants.p =  add_symbol((yyvsp[-9].string),SYM_CONSTANTS,c);
   op[lastop].opcode=CONSTANTS;
-  lastop++;
+  next_op();
 }
+#line 1430 "y.tab.c"
     break;
 
-  case 9:
-#line 122 "mdl.y"
-    {
+  case 9: /* command: CONSTANTS STRING DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE  */
+#line 130 "mdl.y"
+{
   lineno++;
   c = (struct constants *)malloc(sizeof(struct constants));
-  c->r[0]=(yyvsp[(3) - (14)].val);
-  c->r[1]=(yyvsp[(4) - (14)].val);
-  c->r[2]=(yyvsp[(5) - (14)].val);
+  c->r[0]=(yyvsp[-11].val);
+  c->r[1]=(yyvsp[-10].val);
+  c->r[2]=(yyvsp[-9].val);
   c->r[3]=0;
 
-  c->g[0]=(yyvsp[(6) - (14)].val);
-  c->g[1]=(yyvsp[(7) - (14)].val);
-  c->g[2]=(yyvsp[(8) - (14)].val);
+  c->g[0]=(yyvsp[-8].val);
+  c->g[1]=(yyvsp[-7].val);
+  c->g[2]=(yyvsp[-6].val);
   c->g[3]=0;
 
-  c->b[0]=(yyvsp[(9) - (14)].val);
-  c->b[1]=(yyvsp[(10) - (14)].val);
-  c->b[2]=(yyvsp[(11) - (14)].val);
+  c->b[0]=(yyvsp[-5].val);
+  c->b[1]=(yyvsp[-4].val);
+  c->b[2]=(yyvsp[-3].val);
   c->b[3]=0;
 
-  c->red = (yyvsp[(12) - (14)].val);
-  c->green = (yyvsp[(13) - (14)].val);
-  c->blue = (yyvsp[(14) - (14)].val);
-  op[lastop].op.constants.p =  add_symbol((yyvsp[(2) - (14)].string),SYM_CONSTANTS,c);
+  c->red = (yyvsp[-2].val);
+  c->green = (yyvsp[-1].val);
+  c->blue = (yyvsp[0].val);
+  op[lastop].op.constants.p =  add_symbol((yyvsp[-12].string),SYM_CONSTANTS,c);
   op[lastop].opcode=CONSTANTS;
-  lastop++;
+  next_op();
 }
+#line 1460 "y.tab.c"
     break;
 
-  case 10:
-#line 149 "mdl.y"
-    {
+  case 10: /* command: SAVE_COORDS STRING  */
+#line 157 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = SAVE_COORDS;
-  m = new_matrix(4,4);
-  op[lastop].op.save_coordinate_system.p = add_symbol((yyvsp[(2) - (2)].string),SYM_MATRIX,m);
-  lastop++;
+  op[lastop].op.save_coordinate_system.p = add_symbol((yyvsp[0].string),SYM_MATRIX,0);
+  next_op();
 }
+#line 1471 "y.tab.c"
     break;
 
-  case 11:
-#line 158 "mdl.y"
-    {
+  case 11: /* command: CAMERA DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE  */
+#line 165 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = CAMERA;
-  op[lastop].op.camera.eye[0] = (yyvsp[(2) - (7)].val);
-  op[lastop].op.camera.eye[1] = (yyvsp[(3) - (7)].val);
-  op[lastop].op.camera.eye[2] = (yyvsp[(4) - (7)].val);
+  op[lastop].op.camera.eye[0] = (yyvsp[-5].val);
+  op[lastop].op.camera.eye[1] = (yyvsp[-4].val);
+  op[lastop].op.camera.eye[2] = (yyvsp[-3].val);
   op[lastop].op.camera.eye[3] = 0;
-  op[lastop].op.camera.aim[0] = (yyvsp[(5) - (7)].val);
-  op[lastop].op.camera.aim[1] = (yyvsp[(6) - (7)].val);
-  op[lastop].op.camera.aim[2] = (yyvsp[(7) - (7)].val);
+  op[lastop].op.camera.aim[0] = (yyvsp[-2].val);
+  op[lastop].op.camera.aim[1] = (yyvsp[-1].val);
+  op[lastop].op.camera.aim[2] = (yyvsp[0].val);
   op[lastop].op.camera.aim[3] = 0;
-  lastop++;
+  next_op();
 }
+#line 1489 "y.tab.c"
     break;
 
-  case 12:
-#line 172 "mdl.y"
-    {
+  case 12: /* command: TEXTURE STRING DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE  */
+#line 179 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = TEXTURE;
   c = (struct constants *)malloc(sizeof(struct constants));
-  op[lastop].op.texture.d0[0] = (yyvsp[(3) - (14)].val);
-  op[lastop].op.texture.d0[1] = (yyvsp[(4) - (14)].val);
-  op[lastop].op.texture.d0[2] = (yyvsp[(5) - (14)].val);
-  op[lastop].op.texture.d1[0] = (yyvsp[(6) - (14)].val);
-  op[lastop].op.texture.d1[1] = (yyvsp[(7) - (14)].val);
-  op[lastop].op.texture.d1[2] = (yyvsp[(8) - (14)].val);
-  op[lastop].op.texture.d2[0] = (yyvsp[(9) - (14)].val);
-  op[lastop].op.texture.d2[1] = (yyvsp[(10) - (14)].val);
-  op[lastop].op.texture.d2[2] = (yyvsp[(11) - (14)].val);
-  op[lastop].op.texture.d3[0] = (yyvsp[(12) - (14)].val);
-  op[lastop].op.texture.d3[1] = (yyvsp[(13) - (14)].val);
-  op[lastop].op.texture.d3[2] = (yyvsp[(14) - (14)].val);
+  op[lastop].op.texture.d0[0] = (yyvsp[-11].val);
+  op[lastop].op.texture.d0[1] = (yyvsp[-10].val);
+  op[lastop].op.texture.d0[2] = (yyvsp[-9].val);
+  op[lastop].op.texture.d1[0] = (yyvsp[-8].val);
+  op[lastop].op.texture.d1[1] = (yyvsp[-7].val);
+  op[lastop].op.texture.d1[2] = (yyvsp[-6].val);
+  op[lastop].op.texture.d2[0] = (yyvsp[-5].val);
+  op[lastop].op.texture.d2[1] = (yyvsp[-4].val);
+  op[lastop].op.texture.d2[2] = (yyvsp[-3].val);
+  op[lastop].op.texture.d3[0] = (yyvsp[-2].val);
+  op[lastop].op.texture.d3[1] = (yyvsp[-1].val);
+  op[lastop].op.texture.d3[2] = (yyvsp[0].val);
   op[lastop].op.texture.cs = NULL;
   op[lastop].op.texture.constants =  add_symbol("",SYM_CONSTANTS,c);
-  op[lastop].op.texture.p = add_symbol((yyvsp[(2) - (14)].string),SYM_FILE,0);
-  lastop++;
+  op[lastop].op.texture.p = add_symbol((yyvsp[-12].string),SYM_FILE,0);
+  next_op();
 }
+#line 1515 "y.tab.c"
     break;
 
-  case 13:
-#line 194 "mdl.y"
-    {
+  case 13: /* command: SPHERE DOUBLE DOUBLE DOUBLE DOUBLE  */
+#line 201 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = SPHERE;
-  op[lastop].op.sphere.d[0] = (yyvsp[(2) - (5)].val);
-  op[lastop].op.sphere.d[1] = (yyvsp[(3) - (5)].val);
-  op[lastop].op.sphere.d[2] = (yyvsp[(4) - (5)].val);
+  op[lastop].op.sphere.d[0] = (yyvsp[-3].val);
+  op[lastop].op.sphere.d[1] = (yyvsp[-2].val);
+  op[lastop].op.sphere.d[2] = (yyvsp[-1].val);
   op[lastop].op.sphere.d[3] = 0;
-  op[lastop].op.sphere.r = (yyvsp[(5) - (5)].val);
+  op[lastop].op.sphere.r = (yyvsp[0].val);
   op[lastop].op.sphere.constants = NULL;
   op[lastop].op.sphere.cs = NULL;
-  lastop++;
+  next_op();
 }
+#line 1532 "y.tab.c"
     break;
 
-  case 14:
-#line 207 "mdl.y"
-    {
+  case 14: /* command: SPHERE DOUBLE DOUBLE DOUBLE DOUBLE STRING  */
+#line 214 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = SPHERE;
-  op[lastop].op.sphere.d[0] = (yyvsp[(2) - (6)].val);
-  op[lastop].op.sphere.d[1] = (yyvsp[(3) - (6)].val);
-  op[lastop].op.sphere.d[2] = (yyvsp[(4) - (6)].val);
+  op[lastop].op.sphere.d[0] = (yyvsp[-4].val);
+  op[lastop].op.sphere.d[1] = (yyvsp[-3].val);
+  op[lastop].op.sphere.d[2] = (yyvsp[-2].val);
   op[lastop].op.sphere.d[3] = 0;
-  op[lastop].op.sphere.r = (yyvsp[(5) - (6)].val);
+  op[lastop].op.sphere.r = (yyvsp[-1].val);
   op[lastop].op.sphere.constants = NULL;
-  m = (struct matrix *)new_matrix(4,4);
-  op[lastop].op.sphere.cs = add_symbol((yyvsp[(6) - (6)].string),SYM_MATRIX,m);
-  lastop++;
+  op[lastop].op.sphere.cs = add_symbol((yyvsp[0].string),SYM_MATRIX,0);
+  next_op();
 }
+#line 1549 "y.tab.c"
     break;
 
-  case 15:
-#line 221 "mdl.y"
-    {
+  case 15: /* command: SPHERE STRING DOUBLE DOUBLE DOUBLE DOUBLE  */
+#line 227 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = SPHERE;
-  op[lastop].op.sphere.d[0] = (yyvsp[(3) - (6)].val);
-  op[lastop].op.sphere.d[1] = (yyvsp[(4) - (6)].val);
-  op[lastop].op.sphere.d[2] = (yyvsp[(5) - (6)].val);
+  op[lastop].op.sphere.d[0] = (yyvsp[-3].val);
+  op[lastop].op.sphere.d[1] = (yyvsp[-2].val);
+  op[lastop].op.sphere.d[2] = (yyvsp[-1].val);
   op[lastop].op.sphere.d[3] = 0;
-  op[lastop].op.sphere.r = (yyvsp[(6) - (6)].val);
+  op[lastop].op.sphere.r = (yyvsp[0].val);
   op[lastop].op.sphere.cs = NULL;
   c = (struct constants *)malloc(sizeof(struct constants));
-  op[lastop].op.sphere.constants = add_symbol((yyvsp[(2) - (6)].string),SYM_CONSTANTS,c);
-  lastop++;
+  op[lastop].op.sphere.constants = add_symbol((yyvsp[-4].string),SYM_CONSTANTS,c);
+  next_op();
 }
+#line 1567 "y.tab.c"
     break;
 
-  case 16:
-#line 235 "mdl.y"
-    {
+  case 16: /* command: SPHERE STRING DOUBLE DOUBLE DOUBLE DOUBLE STRING  */
+#line 241 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = SPHERE;
-  op[lastop].op.sphere.d[0] = (yyvsp[(3) - (7)].val);
-  op[lastop].op.sphere.d[1] = (yyvsp[(4) - (7)].val);
-  op[lastop].op.sphere.d[2] = (yyvsp[(5) - (7)].val);
+  op[lastop].op.sphere.d[0] = (yyvsp[-4].val);
+  op[lastop].op.sphere.d[1] = (yyvsp[-3].val);
+  op[lastop].op.sphere.d[2] = (yyvsp[-2].val);
   op[lastop].op.sphere.d[3] = 0;
-  op[lastop].op.sphere.r = (yyvsp[(6) - (7)].val);
+  op[lastop].op.sphere.r = (yyvsp[-1].val);
   op[lastop].op.sphere.constants = NULL;
-  m = (struct matrix *)new_matrix(4,4);
-  op[lastop].op.sphere.cs = add_symbol((yyvsp[(7) - (7)].string),SYM_MATRIX,m);
+  op[lastop].op.sphere.cs = add_symbol((yyvsp[0].string),SYM_MATRIX,0);
   c = (struct constants *)malloc(sizeof(struct constants));
-  op[lastop].op.sphere.constants = add_symbol((yyvsp[(2) - (7)].string),SYM_CONSTANTS,c);
-  lastop++;
+  op[lastop].op.sphere.constants = add_symbol((yyvsp[-5].string),SYM_CONSTANTS,c);
+  next_op();
 }
+#line 1586 "y.tab.c"
     break;
 
-  case 17:
-#line 252 "mdl.y"
-    {
+  case 17: /* command: TORUS DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE  */
+#line 257 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = TORUS;
-  op[lastop].op.torus.d[0] = (yyvsp[(2) - (6)].val);
-  op[lastop].op.torus.d[1] = (yyvsp[(3) - (6)].val);
-  op[lastop].op.torus.d[2] = (yyvsp[(4) - (6)].val);
+  op[lastop].op.torus.d[0] = (yyvsp[-4].val);
+  op[lastop].op.torus.d[1] = (yyvsp[-3].val);
+  op[lastop].op.torus.d[2] = (yyvsp[-2].val);
   op[lastop].op.torus.d[3] = 0;
-  op[lastop].op.torus.r0 = (yyvsp[(5) - (6)].val);
-  op[lastop].op.torus.r1 = (yyvsp[(6) - (6)].val);
+  op[lastop].op.torus.r0 = (yyvsp[-1].val);
+  op[lastop].op.torus.r1 = (yyvsp[0].val);
   op[lastop].op.torus.constants = NULL;
   op[lastop].op.torus.cs = NULL;
 
-  lastop++;
+  next_op();
 }
+#line 1605 "y.tab.c"
     break;
 
-  case 18:
-#line 267 "mdl.y"
-    {
+  case 18: /* command: TORUS DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE STRING  */
+#line 272 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = TORUS;
-  op[lastop].op.torus.d[0] = (yyvsp[(2) - (7)].val);
-  op[lastop].op.torus.d[1] = (yyvsp[(3) - (7)].val);
-  op[lastop].op.torus.d[2] = (yyvsp[(4) - (7)].val);
+  op[lastop].op.torus.d[0] = (yyvsp[-5].val);
+  op[lastop].op.torus.d[1] = (yyvsp[-4].val);
+  op[lastop].op.torus.d[2] = (yyvsp[-3].val);
   op[lastop].op.torus.d[3] = 0;
-  op[lastop].op.torus.r0 = (yyvsp[(5) - (7)].val);
-  op[lastop].op.torus.r1 = (yyvsp[(6) - (7)].val);
+  op[lastop].op.torus.r0 = (yyvsp[-2].val);
+  op[lastop].op.torus.r1 = (yyvsp[-1].val);
   op[lastop].op.torus.constants = NULL;
-  m = (struct matrix *)new_matrix(4,4);
-  op[lastop].op.torus.cs = add_symbol((yyvsp[(7) - (7)].string),SYM_MATRIX,m);
-  lastop++;
+  op[lastop].op.torus.cs = add_symbol((yyvsp[0].string),SYM_MATRIX,0);
+  next_op();
 }
+#line 1623 "y.tab.c"
     break;
 
-  case 19:
-#line 282 "mdl.y"
-    {
+  case 19: /* command: TORUS STRING DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE  */
+#line 286 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = TORUS;
-  op[lastop].op.torus.d[0] = (yyvsp[(3) - (7)].val);
-  op[lastop].op.torus.d[1] = (yyvsp[(4) - (7)].val);
-  op[lastop].op.torus.d[2] = (yyvsp[(5) - (7)].val);
+  op[lastop].op.torus.d[0] = (yyvsp[-4].val);
+  op[lastop].op.torus.d[1] = (yyvsp[-3].val);
+  op[lastop].op.torus.d[2] = (yyvsp[-2].val);
   op[lastop].op.torus.d[3] = 0;
-  op[lastop].op.torus.r0 = (yyvsp[(6) - (7)].val);
-  op[lastop].op.torus.r1 = (yyvsp[(7) - (7)].val);
+  op[lastop].op.torus.r0 = (yyvsp[-1].val);
+  op[lastop].op.torus.r1 = (yyvsp[0].val);
   op[lastop].op.torus.cs = NULL;
   c = (struct constants *)malloc(sizeof(struct constants));
-  op[lastop].op.torus.constants = add_symbol((yyvsp[(2) - (7)].string),SYM_CONSTANTS,c);
+  op[lastop].op.torus.constants = add_symbol((yyvsp[-5].string),SYM_CONSTANTS,c);
 
-  lastop++;
+  next_op();
 }
+#line 1643 "y.tab.c"
     break;
 
-  case 20:
-#line 298 "mdl.y"
-    {
+  case 20: /* command: TORUS STRING DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE STRING  */
+#line 302 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = TORUS;
-  op[lastop].op.torus.d[0] = (yyvsp[(3) - (8)].val);
-  op[lastop].op.torus.d[1] = (yyvsp[(4) - (8)].val);
-  op[lastop].op.torus.d[2] = (yyvsp[(5) - (8)].val);
+  op[lastop].op.torus.d[0] = (yyvsp[-5].val);
+  op[lastop].op.torus.d[1] = (yyvsp[-4].val);
+  op[lastop].op.torus.d[2] = (yyvsp[-3].val);
   op[lastop].op.torus.d[3] = 0;
-  op[lastop].op.torus.r0 = (yyvsp[(6) - (8)].val);
-  op[lastop].op.torus.r1 = (yyvsp[(7) - (8)].val);
+  op[lastop].op.torus.r0 = (yyvsp[-2].val);
+  op[lastop].op.torus.r1 = (yyvsp[-1].val);
   c = (struct constants *)malloc(sizeof(struct constants));
-  op[lastop].op.torus.constants = add_symbol((yyvsp[(2) - (8)].string),SYM_CONSTANTS,c);
-  m = (struct matrix *)new_matrix(4,4);
-  op[lastop].op.torus.cs = add_symbol((yyvsp[(8) - (8)].string),SYM_MATRIX,m);
+  op[lastop].op.torus.constants = add_symbol((yyvsp[-6].string),SYM_CONSTANTS,c);
+  op[lastop].op.torus.cs = add_symbol((yyvsp[0].string),SYM_MATRIX,0);
 
-  lastop++;
+  next_op();
 }
+#line 1663 "y.tab.c"
     break;
 
-  case 21:
-#line 315 "mdl.y"
-    {
+  case 21: /* command: BOX DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE  */
+#line 318 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = BOX;
-  op[lastop].op.box.d0[0] = (yyvsp[(2) - (7)].val);
-  op[lastop].op.box.d0[1] = (yyvsp[(3) - (7)].val);
-  op[lastop].op.box.d0[2] = (yyvsp[(4) - (7)].val);
+  op[lastop].op.box.d0[0] = (yyvsp[-5].val);
+  op[lastop].op.box.d0[1] = (yyvsp[-4].val);
+  op[lastop].op.box.d0[2] = (yyvsp[-3].val);
   op[lastop].op.box.d0[3] = 0;
-  op[lastop].op.box.d1[0] = (yyvsp[(5) - (7)].val);
-  op[lastop].op.box.d1[1] = (yyvsp[(6) - (7)].val);
-  op[lastop].op.box.d1[2] = (yyvsp[(7) - (7)].val);
+  op[lastop].op.box.d1[0] = (yyvsp[-2].val);
+  op[lastop].op.box.d1[1] = (yyvsp[-1].val);
+  op[lastop].op.box.d1[2] = (yyvsp[0].val);
   op[lastop].op.box.d1[3] = 0;
 
   op[lastop].op.box.constants = NULL;
   op[lastop].op.box.cs = NULL;
-  lastop++;
+  next_op();
 }
+#line 1684 "y.tab.c"
     break;
 
-  case 22:
-#line 332 "mdl.y"
-    {
+  case 22: /* command: BOX DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE STRING  */
+#line 335 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = BOX;
-  op[lastop].op.box.d0[0] = (yyvsp[(2) - (8)].val);
-  op[lastop].op.box.d0[1] = (yyvsp[(3) - (8)].val);
-  op[lastop].op.box.d0[2] = (yyvsp[(4) - (8)].val);
+  op[lastop].op.box.d0[0] = (yyvsp[-6].val);
+  op[lastop].op.box.d0[1] = (yyvsp[-5].val);
+  op[lastop].op.box.d0[2] = (yyvsp[-4].val);
   op[lastop].op.box.d0[3] = 0;
-  op[lastop].op.box.d1[0] = (yyvsp[(5) - (8)].val);
-  op[lastop].op.box.d1[1] = (yyvsp[(6) - (8)].val);
-  op[lastop].op.box.d1[2] = (yyvsp[(7) - (8)].val);
+  op[lastop].op.box.d1[0] = (yyvsp[-3].val);
+  op[lastop].op.box.d1[1] = (yyvsp[-2].val);
+  op[lastop].op.box.d1[2] = (yyvsp[-1].val);
   op[lastop].op.box.d1[3] = 0;
 
   op[lastop].op.box.constants = NULL;
-  m = (struct matrix *)new_matrix(4,4);
-  op[lastop].op.box.cs = add_symbol((yyvsp[(8) - (8)].string),SYM_MATRIX,m);
-  lastop++;
+  op[lastop].op.box.cs = add_symbol((yyvsp[0].string),SYM_MATRIX,0);
+  next_op();
 }
+#line 1705 "y.tab.c"
     break;
 
-  case 23:
-#line 350 "mdl.y"
-    {
+  case 23: /* command: BOX STRING DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE  */
+#line 352 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = BOX;
-  op[lastop].op.box.d0[0] = (yyvsp[(3) - (8)].val);
-  op[lastop].op.box.d0[1] = (yyvsp[(4) - (8)].val);
-  op[lastop].op.box.d0[2] = (yyvsp[(5) - (8)].val);
+  op[lastop].op.box.d0[0] = (yyvsp[-5].val);
+  op[lastop].op.box.d0[1] = (yyvsp[-4].val);
+  op[lastop].op.box.d0[2] = (yyvsp[-3].val);
   op[lastop].op.box.d0[3] = 0;
-  op[lastop].op.box.d1[0] = (yyvsp[(6) - (8)].val);
-  op[lastop].op.box.d1[1] = (yyvsp[(7) - (8)].val);
-  op[lastop].op.box.d1[2] = (yyvsp[(8) - (8)].val);
+  op[lastop].op.box.d1[0] = (yyvsp[-2].val);
+  op[lastop].op.box.d1[1] = (yyvsp[-1].val);
+  op[lastop].op.box.d1[2] = (yyvsp[0].val);
   op[lastop].op.box.d1[3] = 0;
   c = (struct constants *)malloc(sizeof(struct constants));
-  op[lastop].op.box.constants = add_symbol((yyvsp[(2) - (8)].string),SYM_CONSTANTS,c);
+  op[lastop].op.box.constants = add_symbol((yyvsp[-6].string),SYM_CONSTANTS,c);
   op[lastop].op.box.cs = NULL;
-  lastop++;
+  next_op();
 }
+#line 1726 "y.tab.c"
     break;
 
-  case 24:
-#line 367 "mdl.y"
-    {
+  case 24: /* command: BOX STRING DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE STRING  */
+#line 369 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = BOX;
-  op[lastop].op.box.d0[0] = (yyvsp[(3) - (9)].val);
-  op[lastop].op.box.d0[1] = (yyvsp[(4) - (9)].val);
-  op[lastop].op.box.d0[2] = (yyvsp[(5) - (9)].val);
+  op[lastop].op.box.d0[0] = (yyvsp[-6].val);
+  op[lastop].op.box.d0[1] = (yyvsp[-5].val);
+  op[lastop].op.box.d0[2] = (yyvsp[-4].val);
   op[lastop].op.box.d0[3] = 0;
-  op[lastop].op.box.d1[0] = (yyvsp[(6) - (9)].val);
-  op[lastop].op.box.d1[1] = (yyvsp[(7) - (9)].val);
-  op[lastop].op.box.d1[2] = (yyvsp[(8) - (9)].val);
+  op[lastop].op.box.d1[0] = (yyvsp[-3].val);
+  op[lastop].op.box.d1[1] = (yyvsp[-2].val);
+  op[lastop].op.box.d1[2] = (yyvsp[-1].val);
   op[lastop].op.box.d1[3] = 0;
   c = (struct constants *)malloc(sizeof(struct constants));
-  op[lastop].op.box.constants = add_symbol((yyvsp[(2) - (9)].string),SYM_CONSTANTS,c);
-  m = (struct matrix *)new_matrix(4,4);
-  op[lastop].op.box.cs = add_symbol((yyvsp[(9) - (9)].string),SYM_MATRIX,m);
+  op[lastop].op.box.constants = add_symbol((yyvsp[-7].string),SYM_CONSTANTS,c);
+  op[lastop].op.box.cs = add_symbol((yyvsp[0].string),SYM_MATRIX,0);
 
-  lastop++;
+  next_op();
 }
+#line 1748 "y.tab.c"
     break;
 
-  case 25:
-#line 388 "mdl.y"
-    {
+  case 25: /* command: LINE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE  */
+#line 389 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = LINE;
-  op[lastop].op.line.p0[0] = (yyvsp[(2) - (7)].val);
-  op[lastop].op.line.p0[1] = (yyvsp[(3) - (7)].val);
-  op[lastop].op.line.p0[2] = (yyvsp[(4) - (7)].val);
+  op[lastop].op.line.p0[0] = (yyvsp[-5].val);
+  op[lastop].op.line.p0[1] = (yyvsp[-4].val);
+  op[lastop].op.line.p0[2] = (yyvsp[-3].val);
   op[lastop].op.line.p0[3] = 0;
-  op[lastop].op.line.p1[0] = (yyvsp[(5) - (7)].val);
-  op[lastop].op.line.p1[1] = (yyvsp[(6) - (7)].val);
-  op[lastop].op.line.p1[2] = (yyvsp[(7) - (7)].val);
+  op[lastop].op.line.p1[0] = (yyvsp[-2].val);
+  op[lastop].op.line.p1[1] = (yyvsp[-1].val);
+  op[lastop].op.line.p1[2] = (yyvsp[0].val);
   op[lastop].op.line.p1[3] = 0;
   op[lastop].op.line.constants = NULL;
   op[lastop].op.line.cs0 = NULL;
   op[lastop].op.line.cs1 = NULL;
-  lastop++;
+  next_op();
 }
+#line 1769 "y.tab.c"
     break;
 
-  case 26:
-#line 406 "mdl.y"
-    {
+  case 26: /* command: LINE DOUBLE DOUBLE DOUBLE STRING DOUBLE DOUBLE DOUBLE  */
+#line 407 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = LINE;
-  op[lastop].op.line.p0[0] = (yyvsp[(2) - (8)].val);
-  op[lastop].op.line.p0[1] = (yyvsp[(3) - (8)].val);
-  op[lastop].op.line.p0[2] = (yyvsp[(4) - (8)].val);
+  op[lastop].op.line.p0[0] = (yyvsp[-6].val);
+  op[lastop].op.line.p0[1] = (yyvsp[-5].val);
+  op[lastop].op.line.p0[2] = (yyvsp[-4].val);
   op[lastop].op.line.p0[3] = 0;
-  op[lastop].op.line.p1[0] = (yyvsp[(6) - (8)].val);
-  op[lastop].op.line.p1[1] = (yyvsp[(7) - (8)].val);
-  op[lastop].op.line.p1[2] = (yyvsp[(8) - (8)].val);
+  op[lastop].op.line.p1[0] = (yyvsp[-2].val);
+  op[lastop].op.line.p1[1] = (yyvsp[-1].val);
+  op[lastop].op.line.p1[2] = (yyvsp[0].val);
   op[lastop].op.line.p1[3] = 0;
   op[lastop].op.line.constants = NULL;
-  m = (struct matrix *)new_matrix(4,4);
-  op[lastop].op.line.cs0 = add_symbol((yyvsp[(5) - (8)].string),SYM_MATRIX,m);
+  op[lastop].op.line.cs0 = add_symbol((yyvsp[-3].string),SYM_MATRIX,0);
   op[lastop].op.line.cs1 = NULL;
-  lastop++;
+  next_op();
 }
+#line 1790 "y.tab.c"
     break;
 
-  case 27:
+  case 27: /* command: LINE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE STRING  */
 #line 424 "mdl.y"
-    {
+{
   lineno++;
   op[lastop].opcode = LINE;
-  op[lastop].op.line.p0[0] = (yyvsp[(2) - (8)].val);
-  op[lastop].op.line.p0[1] = (yyvsp[(3) - (8)].val);
-  op[lastop].op.line.p0[2] = (yyvsp[(4) - (8)].val);
+  op[lastop].op.line.p0[0] = (yyvsp[-6].val);
+  op[lastop].op.line.p0[1] = (yyvsp[-5].val);
+  op[lastop].op.line.p0[2] = (yyvsp[-4].val);
   op[lastop].op.line.p0[3] = 0;
-  op[lastop].op.line.p1[0] = (yyvsp[(5) - (8)].val);
-  op[lastop].op.line.p1[1] = (yyvsp[(6) - (8)].val);
-  op[lastop].op.line.p1[2] = (yyvsp[(7) - (8)].val);
+  op[lastop].op.line.p1[0] = (yyvsp[-3].val);
+  op[lastop].op.line.p1[1] = (yyvsp[-2].val);
+  op[lastop].op.line.p1[2] = (yyvsp[-1].val);
   op[lastop].op.line.p1[3] = 0;
   op[lastop].op.line.constants = NULL;
   op[lastop].op.line.cs0 = NULL;
-  m = (struct matrix *)new_matrix(4,4);
-  op[lastop].op.line.cs1 = add_symbol((yyvsp[(8) - (8)].string),SYM_MATRIX,m);
-  lastop++;
+  op[lastop].op.line.cs1 = add_symbol((yyvsp[0].string),SYM_MATRIX,0);
+  next_op();
 }
+#line 1811 "y.tab.c"
     break;
 
-  case 28:
-#line 442 "mdl.y"
-    {
+  case 28: /* command: LINE DOUBLE DOUBLE DOUBLE STRING DOUBLE DOUBLE DOUBLE STRING  */
+#line 441 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = LINE;
-  op[lastop].op.line.p0[0] = (yyvsp[(2) - (9)].val);
-  op[lastop].op.line.p0[1] = (yyvsp[(3) - (9)].val);
-  op[lastop].op.line.p0[2] = (yyvsp[(4) - (9)].val);
+  op[lastop].op.line.p0[0] = (yyvsp[-7].val);
+  op[lastop].op.line.p0[1] = (yyvsp[-6].val);
+  op[lastop].op.line.p0[2] = (yyvsp[-5].val);
   op[lastop].op.line.p0[3] = 0;
-  op[lastop].op.line.p1[0] = (yyvsp[(6) - (9)].val);
-  op[lastop].op.line.p1[1] = (yyvsp[(7) - (9)].val);
-  op[lastop].op.line.p1[2] = (yyvsp[(8) - (9)].val);
+  op[lastop].op.line.p1[0] = (yyvsp[-3].val);
+  op[lastop].op.line.p1[1] = (yyvsp[-2].val);
+  op[lastop].op.line.p1[2] = (yyvsp[-1].val);
   op[lastop].op.line.p1[3] = 0;
   op[lastop].op.line.constants = NULL;
-  m = (struct matrix *)new_matrix(4,4);
-  op[lastop].op.line.cs0 = add_symbol((yyvsp[(5) - (9)].string),SYM_MATRIX,m);
-  m = (struct matrix *)new_matrix(4,4);
-  op[lastop].op.line.cs1 = add_symbol((yyvsp[(9) - (9)].string),SYM_MATRIX,m);
-  lastop++;
+  op[lastop].op.line.cs0 = add_symbol((yyvsp[-4].string),SYM_MATRIX,0);
+  op[lastop].op.line.cs1 = add_symbol((yyvsp[0].string),SYM_MATRIX,0);
+  next_op();
 }
+#line 1832 "y.tab.c"
     break;
 
-  case 29:
-#line 462 "mdl.y"
-    {
+  case 29: /* command: LINE STRING DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE  */
+#line 459 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = LINE;
-  op[lastop].op.line.p0[0] = (yyvsp[(3) - (8)].val);
-  op[lastop].op.line.p0[1] = (yyvsp[(4) - (8)].val);
-  op[lastop].op.line.p0[2] = (yyvsp[(5) - (8)].val);
+  op[lastop].op.line.p0[0] = (yyvsp[-5].val);
+  op[lastop].op.line.p0[1] = (yyvsp[-4].val);
+  op[lastop].op.line.p0[2] = (yyvsp[-3].val);
   op[lastop].op.line.p0[3] = 0;
-  op[lastop].op.line.p1[0] = (yyvsp[(6) - (8)].val);
-  op[lastop].op.line.p1[1] = (yyvsp[(7) - (8)].val);
-  op[lastop].op.line.p1[2] = (yyvsp[(8) - (8)].val);
+  op[lastop].op.line.p1[0] = (yyvsp[-2].val);
+  op[lastop].op.line.p1[1] = (yyvsp[-1].val);
+  op[lastop].op.line.p1[2] = (yyvsp[0].val);
   op[lastop].op.line.p1[3] = 0;
   c = (struct constants *)malloc(sizeof(struct constants));
-  op[lastop].op.line.constants = add_symbol((yyvsp[(2) - (8)].string),SYM_CONSTANTS,c);
+  op[lastop].op.line.constants = add_symbol((yyvsp[-6].string),SYM_CONSTANTS,c);
   op[lastop].op.line.cs0 = NULL;
   op[lastop].op.line.cs1 = NULL;
-  lastop++;
+  next_op();
 }
+#line 1854 "y.tab.c"
     break;
 
-  case 30:
-#line 480 "mdl.y"
-    {
+  case 30: /* command: LINE STRING DOUBLE DOUBLE DOUBLE STRING DOUBLE DOUBLE DOUBLE  */
+#line 477 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = LINE;
-  op[lastop].op.line.p0[0] = (yyvsp[(3) - (9)].val);
-  op[lastop].op.line.p0[1] = (yyvsp[(4) - (9)].val);
-  op[lastop].op.line.p0[2] = (yyvsp[(5) - (9)].val);
+  op[lastop].op.line.p0[0] = (yyvsp[-6].val);
+  op[lastop].op.line.p0[1] = (yyvsp[-5].val);
+  op[lastop].op.line.p0[2] = (yyvsp[-4].val);
   op[lastop].op.line.p0[3] = 0;
-  op[lastop].op.line.p1[0] = (yyvsp[(7) - (9)].val);
-  op[lastop].op.line.p1[1] = (yyvsp[(8) - (9)].val);
-  op[lastop].op.line.p1[2] = (yyvsp[(9) - (9)].val);
+  op[lastop].op.line.p1[0] = (yyvsp[-2].val);
+  op[lastop].op.line.p1[1] = (yyvsp[-1].val);
+  op[lastop].op.line.p1[2] = (yyvsp[0].val);
   op[lastop].op.line.p1[3] = 0;
   c = (struct constants *)malloc(sizeof(struct constants));
-  op[lastop].op.line.constants = add_symbol((yyvsp[(2) - (9)].string),SYM_CONSTANTS,c);
-  m = (struct matrix *)new_matrix(4,4);
-  op[lastop].op.line.cs0 = add_symbol((yyvsp[(6) - (9)].string),SYM_MATRIX,m);
+  op[lastop].op.line.constants = add_symbol((yyvsp[-7].string),SYM_CONSTANTS,c);
+  op[lastop].op.line.cs0 = add_symbol((yyvsp[-3].string),SYM_MATRIX,0);
   op[lastop].op.line.cs1 = NULL;
-  lastop++;
+  next_op();
 }
+#line 1876 "y.tab.c"
     break;
 
-  case 31:
-#line 499 "mdl.y"
-    {
+  case 31: /* command: LINE STRING DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE DOUBLE STRING  */
+#line 495 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = LINE;
-  op[lastop].op.line.p0[0] = (yyvsp[(3) - (9)].val);
-  op[lastop].op.line.p0[1] = (yyvsp[(4) - (9)].val);
-  op[lastop].op.line.p0[2] = (yyvsp[(5) - (9)].val);
+  op[lastop].op.line.p0[0] = (yyvsp[-6].val);
+  op[lastop].op.line.p0[1] = (yyvsp[-5].val);
+  op[lastop].op.line.p0[2] = (yyvsp[-4].val);
   op[lastop].op.line.p0[3] = 0;
-  op[lastop].op.line.p1[0] = (yyvsp[(6) - (9)].val);
-  op[lastop].op.line.p1[1] = (yyvsp[(7) - (9)].val);
-  op[lastop].op.line.p1[2] = (yyvsp[(8) - (9)].val);
+  op[lastop].op.line.p1[0] = (yyvsp[-3].val);
+  op[lastop].op.line.p1[1] = (yyvsp[-2].val);
+  op[lastop].op.line.p1[2] = (yyvsp[-1].val);
   op[lastop].op.line.p1[3] = 0;
   c = (struct constants *)malloc(sizeof(struct constants));
-  op[lastop].op.line.constants = add_symbol((yyvsp[(2) - (9)].string),SYM_CONSTANTS,c);
+  op[lastop].op.line.constants = add_symbol((yyvsp[-7].string),SYM_CONSTANTS,c);
   op[lastop].op.line.cs0 = NULL;
-  m = (struct matrix *)new_matrix(4,4);
-  op[lastop].op.line.cs1 = add_symbol((yyvsp[(9) - (9)].string),SYM_MATRIX,m);
+  op[lastop].op.line.cs1 = add_symbol((yyvsp[0].string),SYM_MATRIX,0);
   op[lastop].op.line.cs0 = NULL;
-  lastop++;
+  next_op();
 }
+#line 1899 "y.tab.c"
     break;
 
-  case 32:
-#line 519 "mdl.y"
-    {
+  case 32: /* command: LINE STRING DOUBLE DOUBLE DOUBLE STRING DOUBLE DOUBLE DOUBLE STRING  */
+#line 514 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = LINE;
-  op[lastop].op.line.p0[0] = (yyvsp[(3) - (10)].val);
-  op[lastop].op.line.p0[1] = (yyvsp[(4) - (10)].val);
-  op[lastop].op.line.p0[2] = (yyvsp[(5) - (10)].val);
+  op[lastop].op.line.p0[0] = (yyvsp[-7].val);
+  op[lastop].op.line.p0[1] = (yyvsp[-6].val);
+  op[lastop].op.line.p0[2] = (yyvsp[-5].val);
   op[lastop].op.line.p0[3] = 0;
-  op[lastop].op.line.p1[0] = (yyvsp[(7) - (10)].val);
-  op[lastop].op.line.p1[1] = (yyvsp[(8) - (10)].val);
-  op[lastop].op.line.p1[2] = (yyvsp[(9) - (10)].val);
+  op[lastop].op.line.p1[0] = (yyvsp[-3].val);
+  op[lastop].op.line.p1[1] = (yyvsp[-2].val);
+  op[lastop].op.line.p1[2] = (yyvsp[-1].val);
   op[lastop].op.line.p1[3] = 0;
   c = (struct constants *)malloc(sizeof(struct constants));
-  op[lastop].op.line.constants = add_symbol((yyvsp[(2) - (10)].string),SYM_CONSTANTS,c);
-  m = (struct matrix *)new_matrix(4,4);
-  op[lastop].op.line.cs0 = add_symbol((yyvsp[(6) - (10)].string),SYM_MATRIX,m);
-  m = (struct matrix *)new_matrix(4,4);
-  op[lastop].op.line.cs1 = add_symbol((yyvsp[(10) - (10)].string),SYM_MATRIX,m);
-  lastop++;
+  op[lastop].op.line.constants = add_symbol((yyvsp[-8].string),SYM_CONSTANTS,c);
+  op[lastop].op.line.cs0 = add_symbol((yyvsp[-4].string),SYM_MATRIX,0);
+  op[lastop].op.line.cs1 = add_symbol((yyvsp[0].string),SYM_MATRIX,0);
+  next_op();
 }
+#line 1921 "y.tab.c"
     break;
 
-  case 33:
-#line 539 "mdl.y"
-    {
+  case 33: /* command: MESH CO STRING  */
+#line 532 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = MESH;
-  strcpy(op[lastop].op.mesh.name,(yyvsp[(3) - (3)].string));
+  strcpy(op[lastop].op.mesh.name,(yyvsp[0].string));
   op[lastop].op.mesh.constants = NULL;
   op[lastop].op.mesh.cs = NULL;
-  lastop++;
+  next_op();
 }
+#line 1934 "y.tab.c"
     break;
 
-  case 34:
-#line 548 "mdl.y"
-    { /* name and constants */
+  case 34: /* command: MESH STRING CO STRING  */
+#line 541 "mdl.y"
+{ /* name and constants */
   lineno++;
   op[lastop].opcode = MESH;
-  strcpy(op[lastop].op.mesh.name,(yyvsp[(4) - (4)].string));
+  strcpy(op[lastop].op.mesh.name,(yyvsp[0].string));
   c = (struct constants *)malloc(sizeof(struct constants));
-  op[lastop].op.mesh.constants = add_symbol((yyvsp[(2) - (4)].string),SYM_CONSTANTS,c);
+  op[lastop].op.mesh.constants = add_symbol((yyvsp[-2].string),SYM_CONSTANTS,c);
   op[lastop].op.mesh.cs = NULL;
-  lastop++;
+  next_op();
 }
+#line 1948 "y.tab.c"
     break;
 
-  case 35:
-#line 558 "mdl.y"
-    {
+  case 35: /* command: MESH STRING CO STRING STRING  */
+#line 551 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = MESH;
-  strcpy(op[lastop].op.mesh.name,(yyvsp[(4) - (5)].string));
+  strcpy(op[lastop].op.mesh.name,(yyvsp[-1].string));
   c = (struct constants *)malloc(sizeof(struct constants));
-  op[lastop].op.mesh.constants = add_symbol((yyvsp[(2) - (5)].string),SYM_CONSTANTS,c);
-  m = (struct matrix *)new_matrix(4,4);
-  op[lastop].op.mesh.cs = add_symbol((yyvsp[(5) - (5)].string),SYM_MATRIX,m);
-  lastop++;
+  op[lastop].op.mesh.constants = add_symbol((yyvsp[-3].string),SYM_CONSTANTS,c);
+  op[lastop].op.mesh.cs = add_symbol((yyvsp[0].string),SYM_MATRIX,0);
+  next_op();
 }
+#line 1962 "y.tab.c"
     break;
 
-  case 36:
-#line 569 "mdl.y"
-    {
+  case 36: /* command: SET STRING DOUBLE  */
+#line 561 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = SET;
-  op[lastop].op.set.p = add_symbol((yyvsp[(2) - (3)].string),SYM_VALUE,0);
-  set_value(op[lastop].op.set.p,(yyvsp[(3) - (3)].val));
-  op[lastop].op.set.val = (yyvsp[(3) - (3)].val);
-  lastop++;
+  op[lastop].op.set.p = add_symbol((yyvsp[-1].string),SYM_VALUE,0);
+  op[lastop].op.set.knob = knob_slot(op[lastop].op.set.p);
+  set_knob(op[lastop].op.set.knob,(yyvsp[0].val));
+  op[lastop].op.set.val = (yyvsp[0].val);
+  next_op();
 }
+#line 1976 "y.tab.c"
     break;
 
-  case 37:
-#line 578 "mdl.y"
-    {
+  case 37: /* command: SCALE DOUBLE DOUBLE DOUBLE STRING  */
+#line 571 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = SCALE;
-  op[lastop].op.scale.d[0] = (yyvsp[(2) - (5)].val);
-  op[lastop].op.scale.d[1] = (yyvsp[(3) - (5)].val);
-  op[lastop].op.scale.d[2] = (yyvsp[(4) - (5)].val);
+  op[lastop].op.scale.d[0] = (yyvsp[-3].val);
+  op[lastop].op.scale.d[1] = (yyvsp[-2].val);
+  op[lastop].op.scale.d[2] = (yyvsp[-1].val);
   op[lastop].op.scale.d[3] = 0;
-  op[lastop].op.scale.p = add_symbol((yyvsp[(5) - (5)].string),SYM_VALUE,0);
-  lastop++;
+  op[lastop].op.scale.p = add_symbol((yyvsp[0].string),SYM_VALUE,0);
+  op[lastop].op.scale.knob = knob_slot(op[lastop].op.scale.p);
+  next_op();
 }
+#line 1992 "y.tab.c"
     break;
 
-  case 38:
-#line 589 "mdl.y"
-    {
+  case 38: /* command: SCALE DOUBLE DOUBLE DOUBLE  */
+#line 583 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = SCALE;
-  op[lastop].op.scale.d[0] = (yyvsp[(2) - (4)].val);
-  op[lastop].op.scale.d[1] = (yyvsp[(3) - (4)].val);
-  op[lastop].op.scale.d[2] = (yyvsp[(4) - (4)].val);
+  op[lastop].op.scale.d[0] = (yyvsp[-2].val);
+  op[lastop].op.scale.d[1] = (yyvsp[-1].val);
+  op[lastop].op.scale.d[2] = (yyvsp[0].val);
   op[lastop].op.scale.d[3] = 0;
   op[lastop].op.scale.p = NULL;
-  lastop++;
+  op[lastop].op.scale.knob = -1;
+  next_op();
 }
+#line 2008 "y.tab.c"
     break;
 
-  case 39:
-#line 600 "mdl.y"
-    {
+  case 39: /* command: ROTATE STRING DOUBLE STRING  */
+#line 595 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = ROTATE;
-  switch (*(yyvsp[(2) - (4)].string))
+  switch (*(yyvsp[-2].string))
     {
     case 'x':
     case 'X': 
@@ -2198,19 +2028,21 @@ yyreduce:
       break;
     }
 
-  op[lastop].op.rotate.degrees = (yyvsp[(3) - (4)].val);
-  op[lastop].op.rotate.p = add_symbol((yyvsp[(4) - (4)].string),SYM_VALUE,0);
+  op[lastop].op.rotate.degrees = (yyvsp[-1].val);
+  op[lastop].op.rotate.p = add_symbol((yyvsp[0].string),SYM_VALUE,0);
+  op[lastop].op.rotate.knob = knob_slot(op[lastop].op.rotate.p);
   
-  lastop++;
+  next_op();
 }
+#line 2038 "y.tab.c"
     break;
 
-  case 40:
-#line 625 "mdl.y"
-    {
+  case 40: /* command: ROTATE STRING DOUBLE  */
+#line 621 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = ROTATE;
-  switch (*(yyvsp[(2) - (3)].string))
+  switch (*(yyvsp[-1].string))
     {
     case 'x':
     case 'X': 
@@ -2225,262 +2057,255 @@ yyreduce:
       op[lastop].op.rotate.axis = 2;
       break;
     }
-  op[lastop].op.rotate.degrees = (yyvsp[(3) - (3)].val);
+  op[lastop].op.rotate.degrees = (yyvsp[0].val);
   op[lastop].op.rotate.p = NULL;
-  lastop++;
+  op[lastop].op.rotate.knob = -1;
+  next_op();
 }
+#line 2066 "y.tab.c"
     break;
 
-  case 41:
-#line 648 "mdl.y"
-    {
+  case 41: /* command: BASENAME STRING  */
+#line 645 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = BASENAME;
-  op[lastop].op.basename.p = add_symbol((yyvsp[(2) - (2)].string),SYM_STRING,0);
-  lastop++;
+  op[lastop].op.basename.p = add_symbol((yyvsp[0].string),SYM_STRING,0);
+  next_op();
 }
+#line 2077 "y.tab.c"
     break;
 
-  case 42:
-#line 655 "mdl.y"
-    {
+  case 42: /* command: SAVE_KNOBS STRING  */
+#line 652 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = SAVE_KNOBS;
-  op[lastop].op.save_knobs.p = add_symbol((yyvsp[(2) - (2)].string),SYM_STRING,0);
-  lastop++;
+  op[lastop].op.save_knobs.p = add_symbol((yyvsp[0].string),SYM_KNOBLIST,0);
+  next_op();
 }
+#line 2088 "y.tab.c"
     break;
 
-  case 43:
-#line 662 "mdl.y"
-    {
+  case 43: /* command: TWEEN DOUBLE DOUBLE STRING STRING  */
+#line 659 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = TWEEN;
-  op[lastop].op.tween.start_frame = (yyvsp[(2) - (5)].val);
-  op[lastop].op.tween.end_frame = (yyvsp[(3) - (5)].val);
-  op[lastop].op.tween.knob_list0 = add_symbol((yyvsp[(4) - (5)].string),SYM_STRING,0);
-  op[lastop].op.tween.knob_list1 = add_symbol((yyvsp[(5) - (5)].string),SYM_STRING,0);
-  lastop++;
+  op[lastop].op.tween.start_frame = (yyvsp[-3].val);
+  op[lastop].op.tween.end_frame = (yyvsp[-2].val);
+  op[lastop].op.tween.knob_list0 = add_symbol((yyvsp[-1].string),SYM_KNOBLIST,0);
+  op[lastop].op.tween.knob_list1 = add_symbol((yyvsp[0].string),SYM_KNOBLIST,0);
+  next_op();
 }
+#line 2102 "y.tab.c"
     break;
 
-  case 44:
-#line 672 "mdl.y"
-    {
+  case 44: /* command: FRAMES DOUBLE  */
+#line 669 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = FRAMES;
-  op[lastop].op.frames.num_frames = (yyvsp[(2) - (2)].val);
-  lastop++;
+  op[lastop].op.frames.num_frames = (yyvsp[0].val);
+  next_op();
 }
+#line 2113 "y.tab.c"
     break;
 
-  case 45:
-#line 679 "mdl.y"
-    {
+  case 45: /* command: VARY STRING DOUBLE DOUBLE DOUBLE DOUBLE  */
+#line 676 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = VARY;
-  op[lastop].op.vary.p = add_symbol((yyvsp[(2) - (6)].string),SYM_STRING,0);
-  op[lastop].op.vary.start_frame = (yyvsp[(3) - (6)].val);
-  op[lastop].op.vary.end_frame = (yyvsp[(4) - (6)].val);
-  op[lastop].op.vary.start_val = (yyvsp[(5) - (6)].val);
-  op[lastop].op.vary.end_val = (yyvsp[(6) - (6)].val);
-  lastop++;
-}
+  op[lastop].op.vary.p = add_symbol((yyvsp[-4].string),SYM_VALUE,0);
+  op[lastop].op.vary.knob = knob_slot(op[lastop].op.vary.p);
+  op[lastop].op.vary.start_frame = (yyvsp[-3].val);
+  op[lastop].op.vary.end_frame = (yyvsp[-2].val);
+  op[lastop].op.vary.start_val = (yyvsp[-1].val);
+  op[lastop].op.vary.end_val = (yyvsp[0].val);
+  next_op();
+}
+#line 2129 "y.tab.c"
     break;
 
-  case 46:
-#line 690 "mdl.y"
-    {
+  case 46: /* command: PUSH  */
+#line 688 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = PUSH;
-  lastop++;
+  next_op();
 }
+#line 2139 "y.tab.c"
     break;
 
-  case 47:
-#line 696 "mdl.y"
-    {
+  case 47: /* command: GENERATE_RAYFILES  */
+#line 694 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = GENERATE_RAYFILES;
-  lastop++;
+  next_op();
 }
+#line 2149 "y.tab.c"
     break;
 
-  case 48:
-#line 702 "mdl.y"
-    {
+  case 48: /* command: POP  */
+#line 700 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = POP;
-  lastop++;
+  next_op();
 }
+#line 2159 "y.tab.c"
     break;
 
-  case 49:
-#line 708 "mdl.y"
-    {
+  case 49: /* command: SAVE STRING  */
+#line 706 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = SAVE;
-  op[lastop].op.save.p = add_symbol((yyvsp[(2) - (2)].string),SYM_FILE,0);
-  lastop++;
+  op[lastop].op.save.p = add_symbol((yyvsp[0].string),SYM_FILE,0);
+  next_op();
 }
+#line 2170 "y.tab.c"
     break;
 
-  case 50:
-#line 715 "mdl.y"
-    {
+  case 50: /* command: SHADING SHADING_TYPE  */
+#line 713 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = SHADING;
-  op[lastop].op.shading.p = add_symbol((yyvsp[(2) - (2)].string),SYM_STRING,0);
-  lastop++;
+  op[lastop].op.shading.p = add_symbol((yyvsp[0].string),SYM_STRING,0);
+  next_op();
 }
+#line 2181 "y.tab.c"
     break;
 
-  case 51:
-#line 722 "mdl.y"
-    {
+  case 51: /* command: SETKNOBS DOUBLE  */
+#line 720 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = SETKNOBS;
-  op[lastop].op.setknobs.value = (yyvsp[(2) - (2)].val);
-  lastop++;
+  op[lastop].op.setknobs.value = (yyvsp[0].val);
+  next_op();
 }
+#line 2192 "y.tab.c"
     break;
 
-  case 52:
-#line 729 "mdl.y"
-    {
+  case 52: /* command: FOCAL DOUBLE  */
+#line 727 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = FOCAL;
-  op[lastop].op.focal.value = (yyvsp[(2) - (2)].val);
-  lastop++;
+  op[lastop].op.focal.value = (yyvsp[0].val);
+  next_op();
 }
+#line 2203 "y.tab.c"
     break;
 
-  case 53:
-#line 736 "mdl.y"
-    {
+  case 53: /* command: DISPLAY  */
+#line 734 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = DISPLAY;
-  lastop++;
+  next_op();
 }
+#line 2213 "y.tab.c"
     break;
 
-  case 54:
-#line 742 "mdl.y"
-    {
+  case 54: /* command: WEB  */
+#line 740 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = WEB;
-  lastop++;
+  next_op();
 }
+#line 2223 "y.tab.c"
     break;
 
-  case 55:
-#line 748 "mdl.y"
-    {
+  case 55: /* command: AMBIENT DOUBLE DOUBLE DOUBLE  */
+#line 746 "mdl.y"
+{
   lineno++;
   op[lastop].opcode = AMBIENT;
-  op[lastop].op.ambient.c[0] = (yyvsp[(2) - (4)].val);
-  op[lastop].op.ambient.c[1] = (yyvsp[(3) - (4)].val);
-  op[lastop].op.ambient.c[2] = (yyvsp[(4) - (4)].val);
-  lastop++;
+  op[lastop].op.ambient.c[0] = (yyvsp[-2].val);
+  op[lastop].op.ambient.c[1] = (yyvsp[-1].val);
+  op[lastop].op.ambient.c[2] = (yyvsp[0].val);
+  next_op();
 }
+#line 2236 "y.tab.c"
     break;
 
 
-/* Line 1267 of yacc.c.  */
-#line 2391 "y.tab.c"
+#line 2240 "y.tab.c"
+
       default: break;
     }
-  YY_SYMBOL_PRINT ("-> $$ =", yyr1[yyn], &yyval, &yyloc);
+  /* User semantic actions sometimes alter yychar, and that requires
+     that yytoken be updated with the new translation.  We take the
+     approach of translating immediately before every use of yytoken.
+     One alternative is translating here after every semantic action,
+     but that translation would be missed if the semantic action invokes
+     YYABORT, YYACCEPT, or YYERROR immediately after altering yychar or
+     if it invokes YYBACKUP.  In the case of YYABORT or YYACCEPT, an
+     incorrect destructor might then be invoked immediately.  In the
+     case of YYERROR or YYBACKUP, subsequent parser actions might lead
+     to an incorrect destructor call or verbose syntax error message
+     before the lookahead is translated.  */
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
 
   YYPOPSTACK (yylen);
   yylen = 0;
-  YY_STACK_PRINT (yyss, yyssp);
 
   *++yyvsp = yyval;
 
-
-  /* Now `shift' the result of the reduction.  Determine what state
+  /* Now 'shift' the result of the reduction.  Determine what state
      that goes to, based on the state we popped back to and the rule
      number reduced by.  */
-
-  yyn = yyr1[yyn];
-
-  yystate = yypgoto[yyn - YYNTOKENS] + *yyssp;
-  if (0 <= yystate && yystate <= YYLAST && yycheck[yystate] == *yyssp)
-    yystate = yytable[yystate];
-  else
-    yystate = yydefgoto[yyn - YYNTOKENS];
+  {
+    const int yylhs = yyr1[yyn] - YYNTOKENS;
+    const int yyi = yypgoto[yylhs] + *yyssp;
+    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
+               ? yytable[yyi]
+               : yydefgoto[yylhs]);
+  }
 
   goto yynewstate;
 
 
-/*------------------------------------.
-| yyerrlab -- here on detecting error |
-`------------------------------------*/
+/*--------------------------------------.
+| yyerrlab -- here on detecting error.  |
+`--------------------------------------*/
 yyerrlab:
+  /* Make sure we have latest lookahead translation.  See comments at
+     user semantic actions for why this is necessary.  */
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
   /* If not already recovering from an error, report this error.  */
   if (!yyerrstatus)
     {
       ++yynerrs;
-#if ! YYERROR_VERBOSE
       yyerror (YY_("syntax error"));
-#else
-      {
-	YYSIZE_T yysize = yysyntax_error (0, yystate, yychar);
-	if (yymsg_alloc < yysize && yymsg_alloc < YYSTACK_ALLOC_MAXIMUM)
-	  {
-	    YYSIZE_T yyalloc = 2 * yysize;
-	    if (! (yysize <= yyalloc && yyalloc <= YYSTACK_ALLOC_MAXIMUM))
-	      yyalloc = YYSTACK_ALLOC_MAXIMUM;
-	    if (yymsg != yymsgbuf)
-	      YYSTACK_FREE (yymsg);
-	    yymsg = (char *) YYSTACK_ALLOC (yyalloc);
-	    if (yymsg)
-	      yymsg_alloc = yyalloc;
-	    else
-	      {
-		yymsg = yymsgbuf;
-		yymsg_alloc = sizeof yymsgbuf;
-	      }
-	  }
-
-	if (0 < yysize && yysize <= yymsg_alloc)
-	  {
-	    (void) yysyntax_error (yymsg, yystate, yychar);
-	    yyerror (yymsg);
-	  }
-	else
-	  {
-	    yyerror (YY_("syntax error"));
-	    if (yysize != 0)
-	      goto yyexhaustedlab;
-	  }
-      }
-#endif
     }
 
-
-
   if (yyerrstatus == 3)
     {
-      /* If just tried and failed to reuse look-ahead token after an
-	 error, discard it.  */
+      /* If just tried and failed to reuse lookahead token after an
+         error, discard it.  */
 
       if (yychar <= YYEOF)
-	{
-	  /* Return failure if at end of input.  */
-	  if (yychar == YYEOF)
-	    YYABORT;
-	}
+        {
+          /* Return failure if at end of input.  */
+          if (yychar == YYEOF)
+            YYABORT;
+        }
       else
-	{
-	  yydestruct ("Error: discarding",
-		      yytoken, &yylval);
-	  yychar = YYEMPTY;
-	}
+        {
+          yydestruct ("Error: discarding",
+                      yytoken, &yylval);
+          yychar = YYEMPTY;
+        }
     }
 
-  /* Else will try to reuse look-ahead token after shifting the error
+  /* Else will try to reuse lookahead token after shifting the error
      token.  */
   goto yyerrlab1;
 
@@ -2489,14 +2314,13 @@ yyerrlab:
 | yyerrorlab -- error raised explicitly by YYERROR.  |
 `---------------------------------------------------*/
 yyerrorlab:
+  /* Pacify compilers when the user code never invokes YYERROR and the
+     label yyerrorlab therefore never appears in user code.  */
+  if (0)
+    YYERROR;
+  ++yynerrs;
 
-  /* Pacify compilers like GCC when the user code never invokes
-     YYERROR and the label yyerrorlab therefore never appears in user
-     code.  */
-  if (/*CONSTCOND*/ 0)
-     goto yyerrorlab;
-
-  /* Do not reclaim the symbols of the rule which action triggered
+  /* Do not reclaim the symbols of the rule whose action triggered
      this YYERROR.  */
   YYPOPSTACK (yylen);
   yylen = 0;
@@ -2509,42 +2333,42 @@ yyerrorlab:
 | yyerrlab1 -- common code for both syntax error and YYERROR.  |
 `-------------------------------------------------------------*/
 yyerrlab1:
-  yyerrstatus = 3;	/* Each real token shifted decrements this.  */
+  yyerrstatus = 3;      /* Each real token shifted decrements this.  */
 
+  /* Pop stack until we find a state that shifts the error token.  */
   for (;;)
     {
       yyn = yypact[yystate];
-      if (yyn != YYPACT_NINF)
-	{
-	  yyn += YYTERROR;
-	  if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYTERROR)
-	    {
-	      yyn = yytable[yyn];
-	      if (0 < yyn)
-		break;
-	    }
-	}
+      if (!yypact_value_is_default (yyn))
+        {
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
+            {
+              yyn = yytable[yyn];
+              if (0 < yyn)
+                break;
+            }
+        }
 
       /* Pop the current state because it cannot handle the error token.  */
       if (yyssp == yyss)
-	YYABORT;
+        YYABORT;
 
 
       yydestruct ("Error: popping",
-		  yystos[yystate], yyvsp);
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp);
       YYPOPSTACK (1);
       yystate = *yyssp;
       YY_STACK_PRINT (yyss, yyssp);
     }
 
-  if (yyn == YYFINAL)
-    YYACCEPT;
-
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
   *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 
 
   /* Shift the error token.  */
-  YY_SYMBOL_PRINT ("Shifting", yystos[yyn], yyvsp, yylsp);
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
 
   yystate = yyn;
   goto yynewstate;
@@ -2555,53 +2379,57 @@ yyerrlab1:
 `-------------------------------------*/
 yyacceptlab:
   yyresult = 0;
-  goto yyreturn;
+  goto yyreturnlab;
+
 
 /*-----------------------------------.
 | yyabortlab -- YYABORT comes here.  |
 `-----------------------------------*/
 yyabortlab:
   yyresult = 1;
-  goto yyreturn;
+  goto yyreturnlab;
 
-#ifndef yyoverflow
-/*-------------------------------------------------.
-| yyexhaustedlab -- memory exhaustion comes here.  |
-`-------------------------------------------------*/
+
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
 yyexhaustedlab:
   yyerror (YY_("memory exhausted"));
   yyresult = 2;
-  /* Fall through.  */
-#endif
+  goto yyreturnlab;
 
-yyreturn:
-  if (yychar != YYEOF && yychar != YYEMPTY)
-     yydestruct ("Cleanup: discarding lookahead",
-		 yytoken, &yylval);
-  /* Do not reclaim the symbols of the rule which action triggered
+
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
+  if (yychar != YYEMPTY)
+    {
+      /* Make sure we have latest lookahead translation.  See comments at
+         user semantic actions for why this is necessary.  */
+      yytoken = YYTRANSLATE (yychar);
+      yydestruct ("Cleanup: discarding lookahead",
+                  yytoken, &yylval);
+    }
+  /* Do not reclaim the symbols of the rule whose action triggered
      this YYABORT or YYACCEPT.  */
   YYPOPSTACK (yylen);
   YY_STACK_PRINT (yyss, yyssp);
   while (yyssp != yyss)
     {
       yydestruct ("Cleanup: popping",
-		  yystos[*yyssp], yyvsp);
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp);
       YYPOPSTACK (1);
     }
 #ifndef yyoverflow
   if (yyss != yyssa)
     YYSTACK_FREE (yyss);
 #endif
-#if YYERROR_VERBOSE
-  if (yymsg != yymsgbuf)
-    YYSTACK_FREE (yymsg);
-#endif
-  /* Make sure YYID is used.  */
-  return YYID (yyresult);
-}
 
+  return yyresult;
+}
 
-#line 761 "mdl.y"
+#line 759 "mdl.y"
 
 
 /* Other C stuff */
@@ -2619,21 +2447,164 @@ int yywrap()
   return 1;
 }
 
+/*======== void grow_ops() ==========
+Inputs:
+Returns:
+
+Doubles the room in op. The new commands are zeroed, like
+the fixed size array op used to be.
+====================*/
+static void grow_ops()
+{
+  int old = max_ops;
+
+  max_ops = max_ops ? max_ops * 2 : 512;
+  op = (struct command *)realloc(op, max_ops * sizeof(struct command));
+  memset(op + old, 0, (max_ops - old) * sizeof(struct command));
+}
+
+/*======== void next_op() ==========
+Inputs:
+Returns:
+
+Moves on to the next command, making sure op[lastop] exists
+====================*/
+void next_op()
+{
+  lastop++;
+  if (lastop == max_ops)
+    grow_ops();
+}
+
 
 extern FILE *yyin;
 
 
+#define USAGE "usage: %s [-r raw_file] [-y video_file] [-s shm_name] [-p]\n" \
+  "           [-i | -u socket | -b batch_file]\n"			\
+  "           [-f first-last | -n shard/n | -m] [-c] script.mdl\n"
+
+/*======== int main() ==========
+  usage: mdl [options] script.mdl
+
+  -r raw_file    write every frame to the raw frame file
+                 raw_file (see output.h) instead of images
+  -y video_file  stream every frame as YUV4MPEG2 to
+                 video_file, which may be a FIFO, or - for
+                 stdout, instead of saving images. Anything
+                 else printed then goes to stderr.
+  -s shm_name    publish display commands and every finished
+                 frame to the shared memory object shm_name
+                 (see display.h) instead of running display
+  -p             draw a still image progressively, publishing
+                 coarse previews to the shared memory display
+                 before the full quality one. When serving,
+                 renders are drawn this way in the background
+                 (see server.c).
+  -i             serve the scene: keep it loaded and draw it
+                 on commands read from stdin (see server.c),
+                 replying on stdout. Anything else printed
+                 then goes to stderr.
+  -u socket      serve the scene to clients of the UNIX
+                 domain socket at socket
+  -b batch_file  draw an image for each knob setting listed
+                 in batch_file (see server.c), using every cpu
+  -f first-last  draw only frames first to last of an animation
+  -n shard/n     split the frames into n shards and draw only
+                 shard number shard (0 to n-1), so n runs, on
+                 any machines, draw every frame exactly once
+  -m             draw nothing, just make the animation from the
+                 frames saved by earlier -f or -n runs
+  -c             keep a journal of the frames saved, and skip
+                 the ones an earlier run of the same script
+                 already saved, to resume after a crash
+  ====================*/
 int main(int argc, char **argv) {
 
-  yyin = fopen(argv[1],"r");
+  int c, n;
 
+  options.y4m_fd = -1;
+  options.first_frame = -1;
+  options.last_frame = -1;
+  while ( (c = getopt(argc, argv, "r:y:s:piu:b:f:n:mc")) != -1 ) {
+    switch (c) {
+    case 'r':
+      options.raw_file = optarg;
+      break;
+    case 'y':
+      options.y4m_file = optarg;
+      break;
+    case 's':
+      options.shm_name = optarg;
+      break;
+    case 'p':
+      options.preview = 1;
+      break;
+    case 'i':
+      options.serve = 1;
+      break;
+    case 'u':
+      options.serve = 1;
+      options.socket_path = optarg;
+      break;
+    case 'b':
+      options.batch_file = optarg;
+      break;
+    case 'f':
+      n = sscanf(optarg, "%d-%d", &options.first_frame, &options.last_frame);
+      if ( n == 1 )
+	options.last_frame = options.first_frame;
+      if ( n < 1 || options.first_frame < 0 || options.last_frame < options.first_frame ) {
+	printf("Error: bad frame range %s\n", optarg);
+	return 1;
+      }
+      break;
+    case 'n':
+      if ( sscanf(optarg, "%d/%d", &options.shard, &options.num_shards) != 2 ||
+	   options.shard < 0 || options.shard >= options.num_shards ) {
+	printf("Error: bad shard %s\n", optarg);
+	return 1;
+      }
+      break;
+    case 'm':
+      options.merge = 1;
+      break;
+    case 'c':
+      options.resume = 1;
+      break;
+    default:
+      printf(USAGE, argv[0]);
+      return 1;
+    }
+  }
+  if ( optind >= argc ) {
+    printf(USAGE, argv[0]);
+    return 1;
+  }
+
+  //keep stdout for the frames or replies and send everything
+  //else to stderr
+  if ( options.y4m_file && !strcmp(options.y4m_file, "-") ) {
+    options.y4m_fd = dup(STDOUT_FILENO);
+    dup2(STDERR_FILENO, STDOUT_FILENO);
+  }
+  else if ( options.serve && !options.socket_path ) {
+    options.reply_fd = dup(STDOUT_FILENO);
+    dup2(STDERR_FILENO, STDOUT_FILENO);
+  }
+
+  options.script_file = argv[optind];
+  yyin = fopen(argv[optind],"r");
+  if ( yyin == NULL ) {
+    printf("Error: could not open %s\n", argv[optind]);
+    return 1;
+  }
+
+  grow_ops();
   yyparse();
   //COMMENT OUT PRINT_PCODE AND UNCOMMENT
   //MY_MAIN IN ORDER TO RUN YOUR CODE
   
   //print_pcode();
-  my_main();
-
-  return 0;    
+  return my_main();
 }
-
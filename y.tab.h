@@ -1,14 +1,14 @@
-/* A Bison parser, made by GNU Bison 2.3.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
-/* Skeleton interface for Bison's Yacc-like parsers in C
+/* Bison interface for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989, 1990, 2000, 2001, 2002, 2003, 2004, 2005, 2006
-   Free Software Foundation, Inc.
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
 
-   This program is free software; you can redistribute it and/or modify
+   This program is free software: you can redistribute it and/or modify
    it under the terms of the GNU General Public License as published by
-   the Free Software Foundation; either version 2, or (at your option)
-   any later version.
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
 
    This program is distributed in the hope that it will be useful,
    but WITHOUT ANY WARRANTY; without even the implied warranty of
@@ -16,9 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program; if not, write to the Free Software
-   Foundation, Inc., 51 Franklin Street, Fifth Floor,
-   Boston, MA 02110-1301, USA.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -33,50 +31,72 @@
    This special exception was added by the Free Software Foundation in
    version 2.2 of Bison.  */
 
-/* Tokens.  */
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+#ifndef YY_YY_Y_TAB_H_INCLUDED
+# define YY_YY_Y_TAB_H_INCLUDED
+/* Debug traces.  */
+#ifndef YYDEBUG
+# define YYDEBUG 0
+#endif
+#if YYDEBUG
+extern int yydebug;
+#endif
+
+/* Token kinds.  */
 #ifndef YYTOKENTYPE
 # define YYTOKENTYPE
-   /* Put the tokens into the symbol table, so that GDB and other debuggers
-      know about them.  */
-   enum yytokentype {
-     COMMENT = 258,
-     DOUBLE = 259,
-     LIGHT = 260,
-     AMBIENT = 261,
-     CONSTANTS = 262,
-     SAVE_COORDS = 263,
-     CAMERA = 264,
-     SPHERE = 265,
-     TORUS = 266,
-     BOX = 267,
-     LINE = 268,
-     CS = 269,
-     MESH = 270,
-     TEXTURE = 271,
-     STRING = 272,
-     SET = 273,
-     MOVE = 274,
-     SCALE = 275,
-     ROTATE = 276,
-     BASENAME = 277,
-     SAVE_KNOBS = 278,
-     TWEEN = 279,
-     FRAMES = 280,
-     VARY = 281,
-     PUSH = 282,
-     POP = 283,
-     SAVE = 284,
-     GENERATE_RAYFILES = 285,
-     SHADING = 286,
-     SHADING_TYPE = 287,
-     SETKNOBS = 288,
-     FOCAL = 289,
-     DISPLAY = 290,
-     WEB = 291,
-     CO = 292
-   };
+  enum yytokentype
+  {
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    COMMENT = 258,                 /* COMMENT  */
+    DOUBLE = 259,                  /* DOUBLE  */
+    LIGHT = 260,                   /* LIGHT  */
+    AMBIENT = 261,                 /* AMBIENT  */
+    CONSTANTS = 262,               /* CONSTANTS  */
+    SAVE_COORDS = 263,             /* SAVE_COORDS  */
+    CAMERA = 264,                  /* CAMERA  */
+    SPHERE = 265,                  /* SPHERE  */
+    TORUS = 266,                   /* TORUS  */
+    BOX = 267,                     /* BOX  */
+    LINE = 268,                    /* LINE  */
+    CS = 269,                      /* CS  */
+    MESH = 270,                    /* MESH  */
+    TEXTURE = 271,                 /* TEXTURE  */
+    STRING = 272,                  /* STRING  */
+    SET = 273,                     /* SET  */
+    MOVE = 274,                    /* MOVE  */
+    SCALE = 275,                   /* SCALE  */
+    ROTATE = 276,                  /* ROTATE  */
+    BASENAME = 277,                /* BASENAME  */
+    SAVE_KNOBS = 278,              /* SAVE_KNOBS  */
+    TWEEN = 279,                   /* TWEEN  */
+    FRAMES = 280,                  /* FRAMES  */
+    VARY = 281,                    /* VARY  */
+    PUSH = 282,                    /* PUSH  */
+    POP = 283,                     /* POP  */
+    SAVE = 284,                    /* SAVE  */
+    GENERATE_RAYFILES = 285,       /* GENERATE_RAYFILES  */
+    SHADING = 286,                 /* SHADING  */
+    SHADING_TYPE = 287,            /* SHADING_TYPE  */
+    SETKNOBS = 288,                /* SETKNOBS  */
+    FOCAL = 289,                   /* FOCAL  */
+    DISPLAY = 290,                 /* DISPLAY  */
+    WEB = 291,                     /* WEB  */
+    CO = 292                       /* CO  */
+  };
+  typedef enum yytokentype yytoken_kind_t;
 #endif
-/* Tokens.  */
+/* Token kinds.  */
+#define YYEMPTY -2
+#define YYEOF 0
+#define YYerror 256
+#define YYUNDEF 257
 #define COMMENT 258
 #define DOUBLE 259
 #define LIGHT 260
@@ -113,24 +133,29 @@
 #define WEB 291
 #define CO 292
 
-
-
-
+/* Value type.  */
 #if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
-typedef union YYSTYPE
-#line 23 "mdl.y"
+union YYSTYPE
 {
+#line 29 "mdl.y"
+
   double val;
   char string[255];
 
-}
-/* Line 1529 of yacc.c.  */
-#line 129 "y.tab.h"
-	YYSTYPE;
-# define yystype YYSTYPE /* obsolescent; will be withdrawn */
-# define YYSTYPE_IS_DECLARED 1
+
+#line 147 "y.tab.h"
+
+};
+typedef union YYSTYPE YYSTYPE;
 # define YYSTYPE_IS_TRIVIAL 1
+# define YYSTYPE_IS_DECLARED 1
 #endif
 
+
 extern YYSTYPE yylval;
 
+
+int yyparse (void);
+
+
+#endif /* !YY_YY_Y_TAB_H_INCLUDED  */